@@ -0,0 +1,26 @@
+/*!
+    @file LCD_Benchmark.h
+    @brief Cycle count benchmarks of the ST7565 driver, built with LCD_BENCHMARK.
+    @details The benchmarks draw with the mylcd and fullScreen objects of
+    main.cpp and print through UART_Print.
+*/
+
+#ifndef LCD_BENCHMARK_H
+#define LCD_BENCHMARK_H
+
+#include "ST7565_Parallel.h"
+
+// main.cpp 中定义
+extern ST7565_Parallel mylcd;
+extern ST7565_Parallel_Screen fullScreen;
+void UART_Print(const char *str);
+
+void LCD_BenchmarkBus(const char *name, ST7565_Bus *bus);
+void LCD_BenchmarkStrip(ST7565_Bus *bus);
+void LCD_BenchmarkBitBand(void);
+void LCD_BenchmarkFill(void);
+void LCD_BenchmarkCrtp(void);
+void LCD_BenchmarkRotation(void);
+void LCD_BenchmarkTranspose(void);
+
+#endif // LCD_BENCHMARK_H
@@ -0,0 +1,82 @@
+/*!
+    @file ST7565_Bus.h
+    @brief Transport interface between the ST7565 driver and the controller.
+    @details ST7565_Parallel only talks to the controller through this
+    interface, so the same drawing code runs over any backend:
+    - ST7565_Bus_Gpio      8080 parallel, HAL_GPIO_WritePin per line
+    - ST7565_Bus_Reg8080   8080 parallel, direct BSRR/BRR register stores
+    - ST7565_Bus_TimDma    8080 parallel, pages streamed by timer + DMA
+    - ST7565_Bus_Spi       4-wire serial, SPI with DMA page bursts
+    - ST7565_Bus_Recording no hardware, records the traffic (host builds)
+*/
+
+#ifndef ST7565_BUS_H
+#define ST7565_BUS_H
+
+#include <stdint.h>
+#include "ST7565_BusTiming.h"
+
+/*! @brief Controller transport, one implementation per bus backend */
+class ST7565_Bus
+{
+public:
+    virtual ~ST7565_Bus() {};
+
+    /*!
+        @brief Configure pins and peripherals, called from LCDbegin
+        @return false if the backend cannot run with its configuration
+     */
+    virtual bool begin(void) = 0;
+    /*!
+        @brief Apply a write cycle timing profile
+        @param timing profile in ns, converted at the current SystemCoreClock
+     */
+    virtual void setTiming(const LCD_BusTiming_t &timing) { (void)timing; };
+    /*!
+        @brief Drive the controller reset line
+        @param active true holds the controller in reset
+     */
+    virtual void reset(bool active) = 0;
+    /*!
+        @brief Send command bytes (A0 low) in one transaction
+        @param commands command bytes
+        @param len number of bytes
+     */
+    virtual void sendCommands(const uint8_t *commands, uint16_t len) = 0;
+    /*!
+        @brief Send display data bytes (A0 high) in one transaction
+        @param data data bytes
+        @param len number of bytes
+     */
+    virtual void sendData(const uint8_t *data, uint16_t len) = 0;
+    /*!
+        @brief Send the same display data byte len times in one transaction
+        @param pattern data byte
+        @param len number of bytes
+     */
+    virtual void fillData(uint8_t pattern, uint16_t len) = 0;
+
+    /*!
+        @brief Whether startDataAsync is available
+        @return true for backends that move data without the CPU
+     */
+    virtual bool canStartAsync(void) { return false; };
+    /*!
+        @brief Start a background data transfer (A0 high), asyncComplete signals the end
+        @param data data bytes, must stay valid until the transfer is complete
+        @param len number of bytes
+     */
+    virtual void startDataAsync(const uint8_t *data, uint16_t len)
+    {
+        (void)data;
+        (void)len;
+    };
+    /*!
+        @brief Acknowledge the end of a background transfer and release the bus
+        @return true if the transfer started by startDataAsync has finished
+        @note Called from the transfer complete interrupt.
+     */
+    virtual bool asyncComplete(void) { return false; };
+};
+
+#endif // ST7565_BUS_H
@@ -0,0 +1,101 @@
+/*!
+    @file ST7565_BusTiming.h
+    @brief 8080 write cycle timing profiles for the supported controllers.
+    @details Values are the write-cycle minimums from the AC characteristics
+    tables (VDD = 2.7V to 3.3V column) and are converted to CPU cycles from
+    SystemCoreClock, so the bus runs as fast as the controller allows
+    instead of a fixed microsecond delay per edge.
+*/
+
+#ifndef ST7565_BUSTIMING_H
+#define ST7565_BUSTIMING_H
+
+#include "stm32f1xx_hal.h"
+#include "dwt_delay.h"
+
+/*! Controller variant, selects the bus timing profile */
+enum LCD_Controller_e : uint8_t
+{
+    LCD_Controller_ST7565P = 0, /**< Sitronix ST7565P */
+    LCD_Controller_ST7567 = 1,  /**< Sitronix ST7567 */
+    LCD_Controller_UC1609 = 2   /**< UltraChip UC1609 */
+};
+
+/*! 8080 write cycle timing in nanoseconds */
+typedef struct
+{
+    uint16_t tAS;  /**< A0 setup before the WR falling edge */
+    uint16_t tAH;  /**< A0 / CS hold after the WR rising edge */
+    uint16_t tCYC; /**< minimum write cycle time */
+    uint16_t tPWL; /**< WR low pulse width, data is latched on the rising edge */
+} LCD_BusTiming_t;
+
+/*! Bus timing converted to CPU cycles at the current SystemCoreClock */
+typedef struct
+{
+    uint32_t setup; /**< tAS */
+    uint32_t hold;  /**< tAH */
+    uint32_t low;   /**< tPWL */
+    uint32_t high;  /**< tCYC - tPWL, WR high time before the next strobe */
+} LCD_BusCycles_t;
+
+static const LCD_BusTiming_t LCD_BusTiming_ST7565P = {0, 0, 300, 90};  /**< tAW8, tAH8, tCYC8, tCCLW */
+static const LCD_BusTiming_t LCD_BusTiming_ST7567 = {0, 0, 240, 80};   /**< tAS8, tAH8, tCY8, tPWL8 */
+static const LCD_BusTiming_t LCD_BusTiming_UC1609 = {10, 10, 400, 120}; /**< tAS, tAH, tCY, tPWL */
+
+/*!
+    @brief Get the timing profile of a controller variant
+    @param controller LCD_Controller_e enum
+    @return pointer to the profile, ST7565P for unknown values
+ */
+static inline const LCD_BusTiming_t *LCD_BusTimingGet(LCD_Controller_e controller)
+{
+    switch (controller)
+    {
+    case LCD_Controller_ST7567:
+        return &LCD_BusTiming_ST7567;
+    case LCD_Controller_UC1609:
+        return &LCD_BusTiming_UC1609;
+    default:
+        return &LCD_BusTiming_ST7565P;
+    }
+}
+
+/*!
+    @brief Convert nanoseconds to CPU cycles at SystemCoreClock, rounded up
+    @param ns nanoseconds
+    @return CPU cycles
+ */
+static inline uint32_t LCD_NsToCycles(uint32_t ns)
+{
+    return (ns * (SystemCoreClock / 1000000U) + 999U) / 1000U;
+}
+
+/*!
+    @brief Convert a timing profile to CPU cycles at SystemCoreClock
+    @param timing the profile in nanoseconds
+    @param cycles the result
+    @note Call again after the system clock changes.
+ */
+static inline void LCD_BusTimingToCycles(const LCD_BusTiming_t *timing, LCD_BusCycles_t *cycles)
+{
+    cycles->setup = LCD_NsToCycles(timing->tAS);
+    cycles->hold = LCD_NsToCycles(timing->tAH);
+    cycles->low = LCD_NsToCycles(timing->tPWL);
+    cycles->high = (timing->tCYC > timing->tPWL) ? LCD_NsToCycles(timing->tCYC - timing->tPWL) : 0;
+}
+
+/*!
+    @brief Busy wait on the DWT cycle counter
+    @param cycles CPU cycles, 0 returns immediately
+    @note dwt_delay_init() must have been called.
+ */
+static inline void LCD_BusWait(uint32_t cycles)
+{
+    if (cycles != 0)
+    {
+        delay_cycles(cycles);
+    }
+}
+
+#endif // ST7565_BUSTIMING_H
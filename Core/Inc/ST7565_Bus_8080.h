@@ -0,0 +1,94 @@
+/*!
+    @file ST7565_Bus_8080.h
+    @brief 8080 parallel bus backends for the ST7565 driver.
+    @details
+    - ST7565_Bus_Gpio: every line through HAL_GPIO_WritePin, the original
+      transport, kept as the reference for benchmarks.
+    - ST7565_Bus_Reg8080: control lines through BSRR/BRR, data lines through
+      the pin-map-aware ST7565_DataBus writer.
+    - ST7565_Bus_TimDma: ST7565_Bus_Reg8080 plus timer paced DMA bursts
+      through a ST7565_DmaPort for LCDupdateAsync.
+*/
+
+#ifndef ST7565_BUS_8080_H
+#define ST7565_BUS_8080_H
+
+#include "stm32f1xx_hal.h"
+#include "ST7565_Bus.h"
+#include "ST7565_DataBus.h"
+#include "ST7565_DmaPort.h"
+
+/*! @brief 8080 parallel bus, HAL_GPIO_WritePin for every line */
+class ST7565_Bus_Gpio : public ST7565_Bus
+{
+public:
+    ST7565_Bus_Gpio(LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins);
+
+    virtual bool begin(void) override;
+    virtual void setTiming(const LCD_BusTiming_t &timing) override;
+    virtual void reset(bool active) override;
+    virtual void sendCommands(const uint8_t *commands, uint16_t len) override;
+    virtual void sendData(const uint8_t *data, uint16_t len) override;
+    virtual void fillData(uint8_t pattern, uint16_t len) override;
+
+    LCD_DataBus_Mode_e getDataBusMode(void) const;
+
+protected:
+    /*!
+        @brief Drive a control line
+        @param pin the line
+        @param high true for high
+     */
+    inline void pinWrite(const LcdDataPin &pin, bool high)
+    {
+        if (!_registerAccess)
+        {
+            HAL_GPIO_WritePin(pin.port, pin.pin, high ? GPIO_PIN_SET : GPIO_PIN_RESET);
+        }
+        else if (high)
+        {
+            pin.port->BSRR = pin.pin;
+        }
+        else
+        {
+            pin.port->BRR = pin.pin;
+        }
+    }
+    void writeRun(bool data, const uint8_t *bytes, uint16_t len, uint8_t step);
+
+    LcdDataPin _LCD_CS;
+    LcdDataPin _LCD_RST;
+    LcdDataPin _LCD_DC;
+    LcdDataPin _LCD_WR;
+    LcdDataPin _LCD_RD;
+    LcdDataPin *_dataPins;
+    ST7565_DataBus _dataBus;       /**< D0-D7 byte writer chosen from _dataPins */
+    LCD_BusCycles_t _busCycles;    /**< write cycle timing in CPU cycles */
+    bool _registerAccess = false;  /**< control lines through BSRR/BRR, data through the fast writer */
+};
+
+/*! @brief 8080 parallel bus, direct register stores */
+class ST7565_Bus_Reg8080 : public ST7565_Bus_Gpio
+{
+public:
+    ST7565_Bus_Reg8080(LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins);
+};
+
+/*! @brief 8080 parallel bus with timer paced DMA data bursts */
+class ST7565_Bus_TimDma : public ST7565_Bus_Reg8080
+{
+public:
+    ST7565_Bus_TimDma(LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins, ST7565_DmaPort *port);
+
+    virtual bool begin(void) override;
+    virtual void setTiming(const LCD_BusTiming_t &timing) override;
+    virtual bool canStartAsync(void) override;
+    virtual void startDataAsync(const uint8_t *data, uint16_t len) override;
+    virtual bool asyncComplete(void) override;
+
+private:
+    ST7565_DmaPort *_dmaPort;
+    bool _dmaReady = false; /**< the DMA port accepted the pin map */
+};
+
+#endif // ST7565_BUS_8080_H
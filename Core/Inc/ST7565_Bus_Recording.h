@@ -0,0 +1,122 @@
+/*!
+    @file ST7565_Bus_Recording.h
+    @brief Host side ST7565 bus backend that records the traffic.
+    @details No hardware access: every byte is appended to a caller supplied
+    log and replayed into a model of the controller (page/column address,
+    start line, contrast, display RAM), so drawing code and the asynchronous
+    page state machine can be checked and measured off target.
+    ST7565_SpiPort_Recording stands in for the SPI hardware under
+    ST7565_Bus_Spi: it feeds what a controller on the serial lines would
+    see into a ST7565_Bus_Recording and counts sequencing errors.
+*/
+
+#ifndef ST7565_BUS_RECORDING_H
+#define ST7565_BUS_RECORDING_H
+
+#include <stdint.h>
+#include "ST7565_Bus.h"
+#include "ST7565_SpiPort.h"
+
+#define LCD_REC_PAGES 9     /**< controller pages, 8 display pages + icon page */
+#define LCD_REC_COLUMNS 132 /**< controller columns per page */
+
+/*! One recorded bus byte */
+typedef struct
+{
+    uint8_t a0;    /**< 0 command, 1 display data */
+    uint8_t value; /**< the byte on D0-D7 */
+} LCD_BusRecord_t;
+
+/*! @brief Bus backend that records bytes and models the controller RAM */
+class ST7565_Bus_Recording : public ST7565_Bus
+{
+public:
+    ST7565_Bus_Recording(LCD_BusRecord_t *log = nullptr, uint32_t logSize = 0);
+
+    virtual bool begin(void) override;
+    virtual void reset(bool active) override;
+    virtual void sendCommands(const uint8_t *commands, uint16_t len) override;
+    virtual void sendData(const uint8_t *data, uint16_t len) override;
+    virtual void fillData(uint8_t pattern, uint16_t len) override;
+    virtual bool canStartAsync(void) override;
+    virtual void startDataAsync(const uint8_t *data, uint16_t len) override;
+    virtual bool asyncComplete(void) override;
+
+    void setAsync(bool enable);
+    void clear(void);
+
+    uint32_t getCommandBytes(void) const { return _commandBytes; };
+    uint32_t getDataBytes(void) const { return _dataBytes; };
+    uint32_t getTransactions(void) const { return _transactions; };
+    uint32_t getResets(void) const { return _resets; };
+    uint32_t getLogLength(void) const { return _logLength; };
+    const LCD_BusRecord_t *getLog(void) const { return _log; };
+    bool isAsyncPending(void) const { return _asyncPending; };
+
+    uint8_t getPage(void) const { return _page; };
+    uint8_t getColumn(void) const { return _column; };
+    uint8_t getStartLine(void) const { return _startLine; };
+    uint8_t getContrast(void) const { return _contrast; };
+    bool isDisplayOn(void) const { return _displayOn; };
+    uint8_t getRam(uint8_t page, uint8_t column) const;
+
+private:
+    void record(uint8_t a0, uint8_t value);
+    void command(uint8_t value);
+    void data(uint8_t value);
+
+    LCD_BusRecord_t *_log;
+    uint32_t _logSize;
+    uint32_t _logLength = 0;
+    uint32_t _commandBytes = 0;
+    uint32_t _dataBytes = 0;
+    uint32_t _transactions = 0;
+    uint32_t _resets = 0;
+
+    bool _asyncEnabled = false;
+    bool _asyncPending = false;
+
+    uint8_t _argCommand = 0; /**< first byte of a two byte command waiting for its argument */
+    uint8_t _page = 0;
+    uint8_t _column = 0;
+    uint8_t _startLine = 0;
+    uint8_t _contrast = 0;
+    bool _displayOn = false;
+    uint8_t _ram[LCD_REC_PAGES][LCD_REC_COLUMNS];
+};
+
+/*! @brief Host-side SPI stand-in, records into a ST7565_Bus_Recording */
+class ST7565_SpiPort_Recording : public ST7565_SpiPort
+{
+public:
+    ST7565_SpiPort_Recording(ST7565_Bus_Recording *sink, uint32_t pclkHz = 72000000U);
+
+    virtual bool begin(uint32_t maxHz) override;
+    virtual uint32_t getClockHz(void) override { return _clockHz; };
+    virtual void reset(bool active) override;
+    virtual void select(bool active) override;
+    virtual void setA0(bool data) override;
+    virtual void write(const uint8_t *data, uint16_t len, uint8_t step) override;
+    virtual void start(const uint8_t *data, uint16_t len, uint8_t step, bool interrupt) override;
+    virtual bool complete(void) override;
+
+    uint32_t getErrors(void) const { return _errors; };
+    uint32_t getDmaBursts(void) const { return _dmaBursts; };
+    uint32_t getPolledBytes(void) const { return _polledBytes; };
+    bool isSelected(void) const { return _selected; };
+
+private:
+    void shift(const uint8_t *data, uint16_t len, uint8_t step);
+
+    ST7565_Bus_Recording *_sink;
+    uint32_t _pclkHz;
+    uint32_t _clockHz = 0;
+    bool _selected = false;
+    bool _a0 = false;
+    bool _dmaPending = false;
+    uint32_t _errors = 0;      /**< bytes without CS, line changes during a burst, overlapping bursts */
+    uint32_t _dmaBursts = 0;
+    uint32_t _polledBytes = 0;
+};
+
+#endif // ST7565_BUS_RECORDING_H
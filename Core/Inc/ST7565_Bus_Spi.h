@@ -0,0 +1,44 @@
+/*!
+    @file ST7565_Bus_Spi.h
+    @brief 4-wire serial (SPI) bus backend for the ST7565 driver.
+    @details Each transaction sets A0, asserts CS, clocks the bytes out and
+    releases CS once the shifter is idle. Runs of LCD_SPI_DMA_MIN_BURST bytes
+    or more go out as DMA transfers, and LCDupdateAsync streams full pages
+    through the DMA transfer complete interrupt. The D0-D7, WR and RD lines
+    are not used.
+*/
+
+#ifndef ST7565_BUS_SPI_H
+#define ST7565_BUS_SPI_H
+
+#include "ST7565_Bus.h"
+#include "ST7565_SpiPort.h"
+
+/*! @brief 4-wire serial bus over a ST7565_SpiPort */
+class ST7565_Bus_Spi : public ST7565_Bus
+{
+public:
+    ST7565_Bus_Spi(ST7565_SpiPort *port, uint32_t maxHz = LCD_SPI_MAX_HZ);
+
+    virtual bool begin(void) override;
+    virtual void reset(bool active) override;
+    virtual void sendCommands(const uint8_t *commands, uint16_t len) override;
+    virtual void sendData(const uint8_t *data, uint16_t len) override;
+    virtual void fillData(uint8_t pattern, uint16_t len) override;
+    virtual bool canStartAsync(void) override;
+    virtual void startDataAsync(const uint8_t *data, uint16_t len) override;
+    virtual bool asyncComplete(void) override;
+
+    void setMaxClock(uint32_t maxHz);
+    uint32_t getClockHz(void);
+
+private:
+    void writeRun(bool data, const uint8_t *bytes, uint16_t len, uint8_t step);
+
+    ST7565_SpiPort *_port;
+    uint32_t _maxHz;
+    bool _ready = false;       /**< the port accepted the configuration */
+    bool _asyncActive = false; /**< a startDataAsync burst is running */
+};
+
+#endif // ST7565_BUS_SPI_H
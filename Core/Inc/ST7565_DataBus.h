@@ -0,0 +1,108 @@
+/*!
+    @file ST7565_DataBus.h
+    @brief 8080 parallel data bus (D0-D7) byte writer for the ST7565 driver.
+    @details The pin map is analysed once in begin() and the cheapest way
+    of putting a byte on the bus is selected:
+    - D0-D7 contiguous and ascending on one port: one shifted BSRR store.
+    - Scattered pins: one BSRR store per used port, taken from a nibble
+      set/reset lookup table precomputed for that port.
+    - Otherwise (or on request): the original HAL_GPIO_WritePin loop.
+*/
+
+#ifndef ST7565_DATABUS_H
+#define ST7565_DATABUS_H
+
+#include "stm32f1xx_hal.h"
+
+// 并口 LCD 引脚描述
+typedef struct
+{
+    GPIO_TypeDef *port;
+    uint16_t pin;
+} LcdDataPin;
+
+#define LCD_DATA_BUS_WIDTH 8     /**< Number of data lines D0-D7 */
+#define LCD_DATA_BUS_MAX_PORTS 4 /**< More ports than this fall back to the generic loop */
+
+/*! Byte writer backend picked from the pin map */
+enum LCD_DataBus_Mode_e : uint8_t
+{
+    LCD_DataBus_Generic = 0,    /**< One HAL_GPIO_WritePin per data line */
+    LCD_DataBus_SinglePort = 1, /**< Contiguous pins on one port, one shifted BSRR store */
+    LCD_DataBus_PortLUT = 2     /**< Scattered pins, one BSRR store per port from a lookup table */
+};
+
+/*! @brief Writes a byte onto the D0-D7 lines described by a LcdDataPin array */
+class ST7565_DataBus
+{
+public:
+    ST7565_DataBus() {};
+    ~ST7565_DataBus();
+
+    void begin(const LcdDataPin *dataPins, bool forceGeneric = false);
+    LCD_DataBus_Mode_e getMode(void) const;
+    uint8_t getPortCount(void) const;
+    GPIO_TypeDef *getPort(void) const;
+
+    /*!
+        @brief BSRR value that puts one byte on the bus
+        @param byte the value, bit i goes to dataPins[i]
+        @return word for getPort()->BSRR, only valid when getPortCount() == 1
+        @note Used to prepare DMA transfers into the data port.
+     */
+    inline uint32_t bsrrWord(uint8_t byte) const
+    {
+        if (_mode == LCD_DataBus_SinglePort)
+        {
+            return ((uint32_t)_mask << 16) | ((uint32_t)byte << _shift);
+        }
+        return ((uint32_t)_lut[0].mask << 16) | _lut[0].low[byte & 0x0F] | _lut[0].high[byte >> 4];
+    }
+
+    /*!
+        @brief Put one byte on D0-D7
+        @param byte the value, bit i goes to dataPins[i]
+     */
+    inline void write(uint8_t byte)
+    {
+        switch (_mode)
+        {
+        case LCD_DataBus_SinglePort:
+            // 置位优先于复位，一次写入即可同时完成 8 位的置位与清零
+            _port->BSRR = ((uint32_t)_mask << 16) | ((uint32_t)byte << _shift);
+            break;
+        case LCD_DataBus_PortLUT:
+            for (uint8_t i = 0; i < _numPorts; i++)
+            {
+                _lut[i].port->BSRR = ((uint32_t)_lut[i].mask << 16) | _lut[i].low[byte & 0x0F] | _lut[i].high[byte >> 4];
+            }
+            break;
+        default:
+            for (uint8_t i = 0; i < LCD_DATA_BUS_WIDTH; i++)
+            {
+                HAL_GPIO_WritePin(_dataPins[i].port, _dataPins[i].pin, (byte >> i) & 0x01 ? GPIO_PIN_SET : GPIO_PIN_RESET);
+            }
+            break;
+        }
+    }
+
+private:
+    /*! Set bits for one port, indexed by the low and high nibble of the data byte */
+    struct PortLUT
+    {
+        GPIO_TypeDef *port;
+        uint16_t mask;     /**< all data pins on this port */
+        uint16_t low[16];  /**< pins to set for D0-D3 */
+        uint16_t high[16]; /**< pins to set for D4-D7 */
+    };
+
+    const LcdDataPin *_dataPins = nullptr;
+    LCD_DataBus_Mode_e _mode = LCD_DataBus_Generic;
+    GPIO_TypeDef *_port = nullptr; /**< SinglePort mode port */
+    uint16_t _mask = 0;            /**< SinglePort mode pin mask */
+    uint8_t _shift = 0;            /**< SinglePort mode bit position of D0 */
+    uint8_t _numPorts = 0;
+    PortLUT *_lut = nullptr;
+};
+
+#endif // ST7565_DATABUS_H
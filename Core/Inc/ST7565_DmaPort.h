@@ -0,0 +1,98 @@
+/*!
+    @file ST7565_DmaPort.h
+    @brief Timer paced DMA transfers from a page buffer into the data port.
+    @details ST7565_DmaPort is the hardware side of LCDupdateAsync, kept
+    behind a small interface so the page state machine in ST7565_Parallel
+    can be driven by a host-side fake. ST7565_DmaPort_Tim is the STM32F1
+    implementation: each byte is expanded to a BSRR word, a compare event
+    of one timer channel requests the DMA write into the data port, and a
+    second channel of the same timer drives WR in PWM mode so the data is
+    latched on its rising edge. The timer runs in one pulse mode with the
+    repetition counter set to the burst length, so exactly one WR strobe is
+    generated per byte.
+*/
+
+#ifndef ST7565_DMAPORT_H
+#define ST7565_DMAPORT_H
+
+#include "stm32f1xx_hal.h"
+#include "ST7565_DataBus.h"
+#include "ST7565_BusTiming.h"
+
+#define LCD_DMA_MAX_BURST 132       /**< Longest burst, one full controller page */
+#define LCD_DMA_LATENCY_CYCLES 12   /**< Timer compare to DMA write on the data port, with margin */
+#define LCD_DMA_MIN_PERIOD_CYCLES 24 /**< Shortest WR cycle the DMA can keep up with */
+
+/*! @brief Hardware interface used by the asynchronous page transfer */
+class ST7565_DmaPort
+{
+public:
+    virtual ~ST7565_DmaPort() {};
+
+    /*!
+        @brief One time setup, called from ST7565_Bus_TimDma::begin
+        @param bus data bus, getPort() is the DMA destination
+        @param wr the WR pin, handed to the timer during a burst
+        @param cycles bus timing in CPU cycles
+        @return true on success
+     */
+    virtual bool begin(const ST7565_DataBus &bus, const LcdDataPin &wr, const LCD_BusCycles_t &cycles) = 0;
+    /*!
+        @brief Start clocking out a burst, A0 and CS are already set
+        @param data bytes to send, len must not exceed LCD_DMA_MAX_BURST
+        @param len number of bytes
+     */
+    virtual void start(const uint8_t *data, uint16_t len) = 0;
+    /*!
+        @brief Acknowledge the transfer complete interrupt
+        @return true if the burst has finished and the last WR strobe is out
+     */
+    virtual bool complete(void) = 0;
+    /*!
+        @brief Give WR back to GPIO control (high), called after CS is released
+     */
+    virtual void stop(void) = 0;
+};
+
+/*! Timer and DMA channel wiring for ST7565_DmaPort_Tim */
+typedef struct
+{
+    TIM_TypeDef *timer;       /**< timer with a repetition counter (TIM1) */
+    uint8_t wrChannel;        /**< timer channel 1-4 driving WR */
+    bool wrComplementary;     /**< WR is on the CHxN output */
+    uint8_t dmaChannel;       /**< timer channel 1-4 whose compare event requests the DMA */
+    DMA_Channel_TypeDef *dma; /**< DMA1 channel mapped to that request */
+    IRQn_Type dmaIRQn;        /**< interrupt of that DMA channel */
+    uint32_t remap;           /**< AFIO MAPR value for the timer pins */
+    uint32_t remapMask;       /**< AFIO MAPR field of the timer */
+} LCD_DmaConfig_t;
+
+/*! WR on PB0 = TIM1_CH2N (partial remap), TIM1_CH1 compare requests DMA1 channel 2 */
+static const LCD_DmaConfig_t LCD_DmaConfig_TIM1_PB0 = {
+    TIM1, 2, true, 1, DMA1_Channel2, DMA1_Channel2_IRQn,
+    AFIO_MAPR_TIM1_REMAP_PARTIALREMAP, AFIO_MAPR_TIM1_REMAP_FULLREMAP};
+
+/*! @brief STM32F1 timer + DMA1 implementation of ST7565_DmaPort */
+class ST7565_DmaPort_Tim : public ST7565_DmaPort
+{
+public:
+    ST7565_DmaPort_Tim(const LCD_DmaConfig_t &config);
+    ~ST7565_DmaPort_Tim();
+
+    virtual bool begin(const ST7565_DataBus &bus, const LcdDataPin &wr, const LCD_BusCycles_t &cycles) override;
+    virtual void start(const uint8_t *data, uint16_t len) override;
+    virtual bool complete(void) override;
+    virtual void stop(void) override;
+
+private:
+    void pinMode(uint32_t cnfMode);
+
+    LCD_DmaConfig_t _config;
+    const ST7565_DataBus *_bus = nullptr;
+    GPIO_TypeDef *_dataPort = nullptr;
+    LcdDataPin _wr = {nullptr, 0};
+    uint8_t _dmaIndex = 0;       /**< DMA1 channel number - 1, for the ISR/IFCR flags */
+    uint32_t *_words = nullptr;  /**< BSRR words of the current burst */
+};
+
+#endif // ST7565_DMAPORT_H
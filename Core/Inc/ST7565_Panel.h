@@ -0,0 +1,185 @@
+/*!
+    @file ST7565_Panel.h
+    @brief ST7565 driver with the panel size fixed at compile time.
+    @details ST7565_Panel<W, H, IconRows> holds the frame buffer, the icon
+    row and the screen object as members, so a global or static panel needs
+    no heap at all (ST7565_Parallel takes the icon row from new). With W and
+    H known to the compiler, drawPixel's bounds checks, rotation and the
+    buffer offset W * (y / 8) + x fold into constants and shifts, one
+    writer per rotation picked by setRotation.
+    Lines, circles, triangles and text come from ST7565_graphics_t, which
+    picks the writer for the rotation once per primitive and calls it
+    directly so it inlines into those loops;
+    fillRect and the fast lines stay on the ST7565_Parallel page engine.
+    Everything else is the ST7565_Parallel API.
+*/
+
+#ifndef ST7565_PANEL_H
+#define ST7565_PANEL_H
+
+#include "ST7565_Parallel.h"
+#include "ST7565_graphics_t.h"
+
+/*!
+    @brief ST7565_Parallel with statically sized buffers
+    @tparam W width in pixels, up to 132 controller columns
+    @tparam H height in pixels, a multiple of 8 up to 64
+    @tparam IconRows 1 for a panel with the icon row (page 8), 0 without
+ */
+template <uint8_t W, uint8_t H, uint8_t IconRows = 1>
+class ST7565_Panel : public ST7565_Parallel, public ST7565_graphics_t<ST7565_Panel<W, H, IconRows>>
+{
+    typedef ST7565_graphics_t<ST7565_Panel<W, H, IconRows>> Graphics;
+    friend Graphics;
+
+    static_assert(W > 0 && W <= 132, "ST7565 has 132 columns");
+    static_assert(H > 0 && H <= LCD_DIRTY_ROWS * 8 && (H % 8) == 0, "height must be whole pages, at most 64 rows");
+    static_assert(IconRows <= 1, "the controller has one icon row");
+
+public:
+    // 两个基类同名的绘图函数：整字节填充用 ST7565_Parallel，其余用静态分派版本
+    using ST7565_Parallel::fillRect;
+    using ST7565_Parallel::drawFastVLine;
+    using ST7565_Parallel::drawFastHLine;
+    using Graphics::drawLine;
+    using Graphics::drawRect;
+    using Graphics::drawCircle;
+    using Graphics::drawCircleHelper;
+    using Graphics::fillCircle;
+    using Graphics::fillCircleHelper;
+    using Graphics::drawTriangle;
+    using Graphics::fillTriangle;
+    using Graphics::drawRoundRect;
+    using Graphics::fillRoundRect;
+    using Graphics::drawChar;
+    using Graphics::drawText;
+
+    static const uint16_t BufferSize = W * (H / 8); /**< frame buffer bytes */
+
+    /*!
+        @brief init the panel, ActiveBuffer points at the built-in frame buffer
+        @param bus the transport, must outlive the object
+     */
+    explicit ST7565_Panel(ST7565_Bus *bus)
+        : ST7565_Parallel(W, H, bus, IconRows ? _icons : nullptr), _screen(_frame, W, H, 0, 0)
+    {
+        memset(_frame, 0x00, BufferSize);
+        ActiveBuffer = &_screen;
+    }
+
+    /*!
+        @brief Getter for the built-in screen, e.g. to switch back after drawing to another one
+        @return the screen object over the panel frame buffer
+     */
+    ST7565_Parallel_Screen *LCDPanelScreenGet(void) { return &_screen; }
+
+    /*!
+        @brief Draws a Pixel, same result as ST7565_Parallel::drawPixel
+        @param x x co-ord of pixel
+        @param y y co-ord of pixel
+        @param colour colour of pixel
+        @note Calls the writer setRotation picked. Other screens, the strip
+        replay and the transposed rotation take the generic path.
+     */
+    virtual void drawPixel(int16_t x, int16_t y, uint8_t colour) override
+    {
+        if (!LCD_PanelDirect())
+        {
+            ST7565_Parallel::drawPixel(x, y, colour);
+            return;
+        }
+        (this->*_panelWriter)(x, y, colour);
+    }
+
+    /*!
+        @brief Sets the rotation and picks the panel pixel writer compiled for it
+        @param rotation LCD_Degrees_0 to LCD_Degrees_270
+     */
+    virtual void setRotation(LCD_rotate_e rotation) override
+    {
+        ST7565_Parallel::setRotation(rotation);
+        switch (rotation)
+        {
+        case LCD_Degrees_90:
+            _panelWriter = &ST7565_Panel::LCD_PanelPixel<LCD_Degrees_90>;
+            break;
+        case LCD_Degrees_180:
+            _panelWriter = &ST7565_Panel::LCD_PanelPixel<LCD_Degrees_180>;
+            break;
+        case LCD_Degrees_270:
+            _panelWriter = &ST7565_Panel::LCD_PanelPixel<LCD_Degrees_270>;
+            break;
+        default:
+            _panelWriter = &ST7565_Panel::LCD_PanelPixel<LCD_Degrees_0>;
+            break;
+        }
+    }
+
+private:
+    /*! @brief true when drawing goes straight into the panel buffer, false for other screens, strip replay and the transposed rotation */
+    bool LCD_PanelDirect(void) const { return ActiveBuffer == &_screen && !_stripReplay && _transposeBuffer == nullptr; }
+
+    /*!
+        @brief drawPixel into the panel buffer for one rotation, W, H and the rotation are constants
+        @param x x co-ord of pixel
+        @param y y co-ord of pixel
+        @param colour colour of pixel
+     */
+    template <uint8_t Rotation>
+    void LCD_PanelPixel(int16_t x, int16_t y, uint8_t colour)
+    {
+        // 旋转后的宽高也是常量
+        const int16_t width = (Rotation & 1) ? H : W;
+        const int16_t height = (Rotation & 1) ? W : H;
+        if ((x < 0) || (x >= width) || (y < 0) || (y >= height))
+            return;
+
+        int16_t bx = x;
+        int16_t by = y;
+        if (Rotation == LCD_Degrees_90)
+        {
+            bx = W - 1 - y;
+            by = x;
+        }
+        else if (Rotation == LCD_Degrees_180)
+        {
+            bx = W - 1 - x;
+            by = H - 1 - y;
+        }
+        else if (Rotation == LCD_Degrees_270)
+        {
+            bx = y;
+            by = H - 1 - x;
+        }
+
+        // 缓冲区按环形使用，原点随硬件滚动移动
+        if (H == LCD_SCROLL_LINES)
+        {
+            by = (by + _scrollLine) & (LCD_SCROLL_LINES - 1);
+        }
+
+        // H <= 64，行号总在脏列数组范围内
+        uint8_t row = by >> 3;
+        if (bx < _drawDirtyMin[row])
+        {
+            _drawDirtyMin[row] = bx;
+        }
+        if (bx > _drawDirtyMax[row])
+        {
+            _drawDirtyMax[row] = bx;
+        }
+        // 双缓冲交换后 screenBuffer 可能指向另一块缓冲区
+        LCD_PixelWrite(&_screen.screenBuffer[W * row + bx], by & 7, colour);
+    }
+
+    void (ST7565_Panel::*_panelWriter)(int16_t, int16_t, uint8_t) = &ST7565_Panel::LCD_PanelPixel<LCD_Degrees_0>; /**< panel drawPixel for the current rotation, set by setRotation */
+    uint8_t _frame[BufferSize];                                       /**< frame buffer, one byte per 8 vertical pixels */
+    uint8_t _icons[IconRows ? ST7565_Parallel::_iconwidthScreen : 1]; /**< icon row (page 8) */
+    ST7565_Parallel_Screen _screen;                                   /**< screen over _frame, the default ActiveBuffer */
+};
+
+typedef ST7565_Panel<128, 64, 1> ST7565_Panel_128x64; /**< 128x64 with icon row */
+typedef ST7565_Panel<128, 32, 1> ST7565_Panel_128x32; /**< 128x32 with icon row */
+typedef ST7565_Panel<132, 64, 1> ST7565_Panel_132x64; /**< full controller RAM, 132x64 with icon row */
+
+#endif // ST7565_PANEL_H
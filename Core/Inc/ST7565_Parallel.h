@@ -10,6 +10,9 @@
 
 #include "main.h"
 #include "ST7565_graphics.h"
+#include "ST7565_Bus.h"
+#include "ST7565_Bus_8080.h"
+#include "ST7565_Bus_Spi.h"
 #include "stm32f1xx_hal.h" // 根据你的 STM32 系列调整
 #include "us_delay.h"
 #include <cstring> // 或者 #include <string.h
@@ -69,32 +72,199 @@
 #define UC1609_HIGHFREQ_DELAY 0 /**< uS  delay, Can be used in software SPI for high freq MCU*/
 // ... 其他延迟定义 ...
 
-// 并口 LCD 控制引脚抽象
+/*! Power-on sequence step kinds */
+enum LCD_InitOp_e : uint8_t
+{
+    LCD_InitOp_End = 0,          /**< end of the table */
+    LCD_InitOp_Command = 1,      /**< send value as a command byte */
+    LCD_InitOp_ResetActive = 2,  /**< pull RST low */
+    LCD_InitOp_ResetRelease = 3, /**< release RST */
+};
 
-#define LCD_CS_HIGH() HAL_GPIO_WritePin(_LCD_CS.port, _LCD_CS.pin, GPIO_PIN_SET)
-#define LCD_CS_LOW() HAL_GPIO_WritePin(_LCD_CS.port, _LCD_CS.pin, GPIO_PIN_RESET)
+/*! One power-on sequence step, delayMs is waited after it */
+typedef struct
+{
+    uint8_t op;       /**< LCD_InitOp_e */
+    uint8_t value;    /**< command byte for LCD_InitOp_Command */
+    uint16_t delayMs; /**< wait after the step in ms */
+} LCD_InitStep_t;
+
+/*! ST7565P power-on sequence, booster/regulator/follower switched on in stages */
+static constexpr LCD_InitStep_t LCD_InitTable_ST7565P[] = {
+    {LCD_InitOp_ResetRelease, 0, UC1609_INIT_DELAY2},
+    {LCD_InitOp_ResetActive, 0, UC1609_INIT_DELAY},
+    {LCD_InitOp_ResetRelease, 0, 0},
+    {LCD_InitOp_Command, CMD_SET_BIAS_9, 0},          // 设置偏置比为1/9
+    {LCD_InitOp_Command, CMD_SET_COM_NORMAL, 0},      // 设置ADC为正常
+    {LCD_InitOp_Command, CMD_SET_COM_REVERSE, 0},     // 设置COM输出方向
+    {LCD_InitOp_Command, CMD_SET_DISP_START_LINE, 0}, // 设置显示起始行
+    {LCD_InitOp_Command, CMD_SET_BOOSTER_FIRST, 0},
+    {LCD_InitOp_Command, CMD_SET_BOOSTER_234, 0},
+    {LCD_InitOp_Command, CMD_SET_POWER_CONTROL | 0x4, 5},
+    {LCD_InitOp_Command, CMD_SET_POWER_CONTROL | 0x6, 5},
+    {LCD_InitOp_Command, CMD_SET_POWER_CONTROL | 0x7, 5},
+    {LCD_InitOp_Command, CMD_SET_RESISTOR_RATIO | 0x4, 5},
+    {LCD_InitOp_End, 0, 0},
+};
 
-#define LCD_RST_HIGH() HAL_GPIO_WritePin(_LCD_RST.port, _LCD_RST.pin, GPIO_PIN_SET)
-#define LCD_RST_LOW() HAL_GPIO_WritePin(_LCD_RST.port, _LCD_RST.pin, GPIO_PIN_RESET)
+/*! ST7567 power-on sequence, short reset pulse and all power circuits at once */
+static constexpr LCD_InitStep_t LCD_InitTable_ST7567[] = {
+    {LCD_InitOp_ResetActive, 0, 1},
+    {LCD_InitOp_ResetRelease, 0, 5},
+    {LCD_InitOp_Command, CMD_SET_BIAS_9, 0},
+    {LCD_InitOp_Command, CMD_SET_ADC_NORMAL, 0},
+    {LCD_InitOp_Command, CMD_SET_COM_REVERSE, 0},
+    {LCD_InitOp_Command, CMD_SET_DISP_START_LINE, 0},
+    {LCD_InitOp_Command, CMD_SET_RESISTOR_RATIO | 0x4, 0},
+    {LCD_InitOp_Command, CMD_SET_POWER_CONTROL | 0x7, 10},
+    {LCD_InitOp_End, 0, 0},
+};
 
-#define LCD_DC_HIGH() HAL_GPIO_WritePin(_LCD_DC.port, _LCD_DC.pin, GPIO_PIN_SET)
-#define LCD_DC_LOW() HAL_GPIO_WritePin(_LCD_DC.port, _LCD_DC.pin, GPIO_PIN_RESET)
+/*!
+    @brief Power-on sequence of a controller variant
+    @param controller LCD_Controller_e enum
+    @return pointer to the table, UC1609 boards run the ST7565P command set
+ */
+inline const LCD_InitStep_t *LCD_InitTableGet(LCD_Controller_e controller)
+{
+    return (controller == LCD_Controller_ST7567) ? LCD_InitTable_ST7567 : LCD_InitTable_ST7565P;
+}
+
+// 引脚、数据线和总线时序由 ST7565_Bus 后端处理，见 ST7565_Bus.h
+
+#define LCD_SCROLL_LINES 64     /**< display lines the controller start line wraps at */
+#define LCD_SHADOW_UNKNOWN 0xFF /**< controller state not known, the next command is always sent */
+#define LCD_COLUMNS 132         /**< controller column counter range, stops at the last column */
+#define LCD_DIRTY_ROWS 8        /**< buffer rows with dirty column tracking, rows below are always sent in full */
+#define LCD_TRANSPOSE_PAGES 16  /**< pages of a transposed (portrait) buffer, panel width / 8 */
+#define LCD_DIFF_MERGE_GAP 3    /**< unchanged bytes sent rather than starting a new run, see LCDDiffMergeGapSet */
+#define LCD_CHUNK_BYTES 16      /**< controller columns per hash in LCD_Diff_Hash mode */
+#define LCD_CHUNKS_PER_PAGE ((LCD_COLUMNS + LCD_CHUNK_BYTES - 1) / LCD_CHUNK_BYTES)
+
+// 主机测试（DWT_DELAY_HOST_MOCK）没有 CRC 外设，用软件计算
+#if defined(DWT_DELAY_HOST_MOCK) && !defined(LCD_CRC_SOFTWARE)
+#define LCD_CRC_SOFTWARE
+#endif
+
+// Cortex-M3 SRAM 位带别名区：每个像素位对应一个字，单次写入即可置位/清零
+#define LCD_BITBAND_SRAM_SIZE 0x00100000U /**< SRAM bytes covered by the bit-band alias */
+// 主机测试的缓冲区不在 SRAM 窗口内，只用普通读改写
+#if defined(DWT_DELAY_HOST_MOCK) && !defined(LCD_BITBAND_OFF)
+#define LCD_BITBAND_OFF
+#endif
+
+/*! How an update finds the bytes that changed inside the dirty columns */
+enum LCD_DiffMode_e : uint8_t
+{
+    LCD_Diff_Off = 0,    /**< send every dirty column */
+    LCD_Diff_Shadow = 1, /**< compare with a full copy of the glass */
+    LCD_Diff_Hash = 2,   /**< compare a CRC-32 per LCD_CHUNK_BYTES columns, for small RAM */
+};
 
-#define LCD_WR_HIGH() HAL_GPIO_WritePin(_LCD_WR.port, _LCD_WR.pin, GPIO_PIN_SET)
-#define LCD_WR_LOW() HAL_GPIO_WritePin(_LCD_WR.port, _LCD_WR.pin, GPIO_PIN_RESET)
+/*! Rectangle in drawing coordinates for LCDupdateRegions */
+typedef struct
+{
+    int16_t x; /**< left edge */
+    int16_t y; /**< top edge */
+    uint8_t w; /**< width in pixels */
+    uint8_t h; /**< height in pixels */
+} LCD_Rect_t;
+
+/*! Strip mode display list operations */
+enum LCD_ListOp_e : uint8_t
+{
+    LCD_ListOp_Pixel = 0,      /**< a, b = x, y */
+    LCD_ListOp_Line = 1,       /**< a, b to c, d */
+    LCD_ListOp_Rect = 2,       /**< a, b = x, y, c, d = w, h */
+    LCD_ListOp_FillRect = 3,   /**< a, b = x, y, c, d = w, h */
+    LCD_ListOp_Circle = 4,     /**< a, b = centre, c = radius */
+    LCD_ListOp_FillCircle = 5, /**< a, b = centre, c = radius */
+    LCD_ListOp_Text = 6,       /**< a, b = x, y, c = size (0 for the number fonts), d = font, data = string */
+    LCD_ListOp_Bitmap = 7,     /**< a, b = x, y, c, d = w, h, data = bitmap */
+};
 
-#define LCD_RD_HIGH() HAL_GPIO_WritePin(_LCD_RD.port, _LCD_RD.pin, GPIO_PIN_SET)
-#define LCD_RD_LOW() HAL_GPIO_WritePin(_LCD_RD.port, _LCD_RD.pin, GPIO_PIN_RESET)
+/*! One recorded draw call, 16 bytes on Cortex-M */
+typedef struct
+{
+    uint8_t op;       /**< LCD_ListOp_e */
+    uint8_t color;    /**< colour, text and bitmap foreground */
+    uint8_t bg;       /**< text and bitmap background */
+    uint8_t reserved; /**< padding */
+    int16_t a;        /**< first coordinate, see LCD_ListOp_e */
+    int16_t b;        /**< second coordinate */
+    int16_t c;        /**< third coordinate */
+    int16_t d;        /**< fourth coordinate */
+    const void *data; /**< string or bitmap, must stay valid until the update */
+} LCD_ListItem_t;
+
+/*! Icons of the default icon table, index into LCDIconTableSet tables */
+enum LCD_Icon_e : uint8_t
+{
+    LCD_Icon_Phone = 0,    /**< columns 2-4, states 0-2 */
+    LCD_Icon_Signal = 1,   /**< columns 20-30, states 0-5 bars */
+    LCD_Icon_Printer = 2,  /**< column 42, off/on */
+    LCD_Icon_Card = 3,     /**< column 61, off/on */
+    LCD_Icon_Lock = 4,     /**< column 77, off/on */
+    LCD_Icon_Battery = 5,  /**< columns 93-105, states 0-4 bars */
+    LCD_Icon_Upload = 6,   /**< column 108, off/on */
+    LCD_Icon_Download = 7, /**< column 122, off/on */
+    LCD_ICON_COUNT = 8     /**< icons in the default table */
+};
 
-// 数据引脚定义（假设使用整个 GPIO 端口作为数据总线）
-// #define LCD_DATA_PORT GPIOB
-// #define LCD_DATA_PINS 0xFF // 假设使用整个 8 位端口
+#define LCD_ICON_KEEP 0xFF /**< setIconStates entry that leaves the icon as it is */
 
+/*! One icon of the status row (page 8) */
 typedef struct
 {
-    GPIO_TypeDef *port;
-    uint16_t pin;
-} LcdDataPin;
+    uint8_t column;          /**< first icon row column */
+    uint8_t width;           /**< columns covered */
+    uint8_t states;          /**< number of states */
+    const uint8_t *patterns; /**< states * width bytes, state s starts at patterns[s * width] */
+} LCD_IconDesc_t;
+
+/*! Phone icon, columns 2-4 */
+static constexpr uint8_t LCD_IconPatterns_Phone[] = {
+    0x00, 0x00, 0x00, // 不显示
+    0xFF, 0x00, 0xFF, // 状态 1
+    0x00, 0xFF, 0xFF, // 状态 2
+};
+
+/*! Signal icon, columns 20-30, a bar on every even column */
+static constexpr uint8_t LCD_IconPatterns_Signal[] = {
+    0x00, 0, 0x00, 0, 0x00, 0, 0x00, 0, 0x00, 0, 0x00, // 无信号
+    0xFF, 0, 0xFF, 0, 0x00, 0, 0x00, 0, 0x00, 0, 0x00, // 1-20
+    0xFF, 0, 0xFF, 0, 0xFF, 0, 0x00, 0, 0x00, 0, 0x00, // 21-50
+    0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0x00, 0, 0x00, // 51-80
+    0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0x00, // 81-99
+    0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, // 100
+};
+
+/*! Battery icon, columns 93-105, frame on 93 and bars on 99-105 */
+static constexpr uint8_t LCD_IconPatterns_Battery[] = {
+    0x00, 0, 0, 0, 0, 0, 0x00, 0, 0x00, 0, 0x00, 0, 0x00, // 0 格
+    0xFF, 0, 0, 0, 0, 0, 0x00, 0, 0x00, 0, 0x00, 0, 0xFF, // 1 格
+    0xFF, 0, 0, 0, 0, 0, 0x00, 0, 0x00, 0, 0xFF, 0, 0xFF, // 2 格
+    0xFF, 0, 0, 0, 0, 0, 0x00, 0, 0xFF, 0, 0xFF, 0, 0xFF, // 3 格
+    0xFF, 0, 0, 0, 0, 0, 0xFF, 0, 0xFF, 0, 0xFF, 0, 0xFF, // 4 格
+};
+
+/*! Single column icon, off/on */
+static constexpr uint8_t LCD_IconPatterns_OnOff[] = {0x00, 0xFF};
+
+/*! Icon row layout of the stock panel, indexed by LCD_Icon_e */
+static constexpr LCD_IconDesc_t LCD_IconTable_Default[LCD_ICON_COUNT] = {
+    {2, 3, 3, LCD_IconPatterns_Phone},
+    {20, 11, 6, LCD_IconPatterns_Signal},
+    {42, 1, 2, LCD_IconPatterns_OnOff},
+    {61, 1, 2, LCD_IconPatterns_OnOff},
+    {77, 1, 2, LCD_IconPatterns_OnOff},
+    {93, 13, 5, LCD_IconPatterns_Battery},
+    {108, 1, 2, LCD_IconPatterns_OnOff},
+    {122, 1, 2, LCD_IconPatterns_OnOff},
+};
+
+/*! Called from interrupt context when an asynchronous update has finished */
+typedef void (*LCD_UpdateCallback_t)(void);
 
 /*! @brief class to hold screen data , multiple screens can be made for the shared buffer. Buffer must be same size and offsets to if saving Data memory is goal
  */
@@ -116,14 +286,52 @@ class ST7565_Parallel : public ST7565_graphics
 {
 public:
     ST7565_Parallel(int16_t width, int16_t height, LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins);
-    ~ST7565_Parallel() = default;
+    ST7565_Parallel(int16_t width, int16_t height, ST7565_Bus *bus);
+    virtual ~ST7565_Parallel();
+    ST7565_Parallel(const ST7565_Parallel &) = delete;            // 拥有堆上的总线和缓冲，不可复制
+    ST7565_Parallel &operator=(const ST7565_Parallel &) = delete;
 
     virtual void drawPixel(int16_t x, int16_t y, uint8_t colour) override;
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour) override;
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint8_t colour) override;
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint8_t colour) override;
+    virtual void setRotation(LCD_rotate_e rotation) override;
     void LCDupdate(void);
+    void LCDupdateRegion(int16_t x, int16_t y, uint8_t w, uint8_t h);
+    void LCDupdateRegions(const LCD_Rect_t *rects, uint8_t count);
+    LCD_Return_Codes_e LCDDoubleBufferSet(uint8_t *front, bool copyBack = true);
+    LCD_Return_Codes_e LCDswap(void);
+    uint8_t *LCDFrontBufferGet(void);
+    LCD_Return_Codes_e LCDStripBegin(LCD_ListItem_t *list, uint16_t size, uint8_t *strip);
+    void LCDListClear(void);
+    uint16_t LCDListLengthGet(void);
+    LCD_Return_Codes_e LCDListPixel(int16_t x, int16_t y, uint8_t colour);
+    LCD_Return_Codes_e LCDListLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t colour);
+    LCD_Return_Codes_e LCDListRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour);
+    LCD_Return_Codes_e LCDListFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour);
+    LCD_Return_Codes_e LCDListCircle(int16_t x, int16_t y, int16_t r, uint8_t colour);
+    LCD_Return_Codes_e LCDListFillCircle(int16_t x, int16_t y, int16_t r, uint8_t colour);
+    LCD_Return_Codes_e LCDListText(int16_t x, int16_t y, const char *text, uint8_t colour, uint8_t bg, uint8_t size = 1);
+    LCD_Return_Codes_e LCDListBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint8_t colour, uint8_t bg);
+    LCD_Return_Codes_e LCDupdateStrip(void);
+    LCD_Return_Codes_e LCDupdateAsync(LCD_UpdateCallback_t callback = nullptr);
+    bool isBusy(void);
+    bool LCDupdateComplete(void);
+    void LCD_DMA_IRQHandler(void);
+    LCD_Return_Codes_e LCDupdateIT(uint16_t bytesPerTick, LCD_UpdateCallback_t callback = nullptr);
+    LCD_Return_Codes_e LCDrefreshTimerBegin(TIM_TypeDef *timer, IRQn_Type timerIRQn, uint32_t tickHz);
+    void LCDrefreshTick(void);
+    uint32_t LCDrefreshTickMaxCycles(void);
     void LCDclearBuffer(void);
     void LCDBuffer(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t *data);
-    void LCDBuffer_Icon(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t *data);
+    void LCDBuffer_Icon(int16_t x, uint8_t w, uint8_t *data);
     void LCDbegin(uint8_t _VbiasPot = _VbiasPOT, uint8_t _AddressSet = _AddressCtrl);
+    LCD_Return_Codes_e LCDbeginAsync(void);
+    void LCDinitTick(void);
+    bool LCDinitDone(void);
+    uint32_t LCDFirstFrameTimeGet(void);
+    void LCDInitTableSet(LCD_Controller_e controller);
+    void LCDInitTableSet(const LCD_InitStep_t *table);
     void LCDinit(void);
     void LCD_Mode(uint8_t set_mode);
     void LCD_Sleep_Enable(void);
@@ -136,9 +344,16 @@ public:
     // void LCDrotate(uint8_t rotatevalue);
     void LCDInvertDisplay(uint8_t on);
     void LCDallpixelsOn(uint8_t bits);
-    // void LCDscroll(uint8_t bits);
+    LCD_Return_Codes_e LCDscroll(int8_t lines);
+    uint8_t LCDscrollGet(void);
+    LCD_Return_Codes_e LCDTransposeSet(uint8_t *portrait, LCD_rotate_e rotation);
+    uint16_t LCDTransposeFlush(void);
+    uint16_t LCDTransposeBlocksGet(void);
     void LCDReset(void);
     LCD_Return_Codes_e LCDBitmap(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *data);
+    void ST7565_send_command_burst(const uint8_t *commands, uint16_t len);
+    void ST7565_send_data_burst(const uint8_t *data, uint16_t len);
+    void ST7565_send_data_fill(uint8_t pattern, uint16_t len);
     // void LCDPowerDown(void);
 
     uint16_t LCDLibVerNumGet(void);
@@ -146,6 +361,29 @@ public:
     void LCDHighFreqDelaySet(uint16_t);
     uint8_t LCDGetConstrast(void);
     uint8_t LCDGetAddressCtrl(void);
+    ST7565_Bus *LCDBusGet(void);
+    void LCDShadowInvalidate(void);
+    uint32_t LCDElidedBytesGet(void);
+    void LCDinvalidateAll(void);
+    uint32_t LCDUpdateBytesGet(void);
+    LCD_Return_Codes_e LCDDiffModeSet(LCD_DiffMode_e mode);
+    LCD_DiffMode_e LCDDiffModeGet(void);
+    void LCDDiffMergeGapSet(uint8_t bytes);
+    uint8_t LCDDiffMergeGapGet(void);
+    uint32_t LCDDiffSavedBytesGet(void);
+    uint32_t LCDDiffRamGet(void);
+    uint32_t LCDDiffChunksGet(void);
+    uint32_t LCDDiffChunkHitsGet(void);
+    void LCDBitBandSet(bool enable);
+    bool LCDBitBandGet(void);
+    void LCDBusTimingSet(LCD_Controller_e controller);
+    void LCDBusTimingSet(const LCD_BusTiming_t &timing);
+    LCD_BusTiming_t LCDBusTimingGet(void);
+
+    void LCDIconTableSet(const LCD_IconDesc_t *table, uint8_t count);
+    LCD_Return_Codes_e setIconState(uint8_t icon, uint8_t state);
+    LCD_Return_Codes_e setIconStates(const uint8_t *states, uint8_t count);
+    void LCDupdateIcons(void);
 
     void LCD_DrawIcon_Battery(uint8_t level);
     void LCD_DrawIcon_Lock(uint8_t status);
@@ -188,20 +426,222 @@ public:
     // void send_command(uint8_t command, uint8_t value);
     // bool isHardwareSPI(void);
     // void CustomshiftOut(uint8_t bitOrder, uint8_t val);
+protected:
+    ST7565_Parallel(int16_t width, int16_t height, ST7565_Bus *bus, uint8_t *iconBuffer);
+
+    // 编译期尺寸的面板直接使用绘图状态
+    template <uint8_t W, uint8_t H, uint8_t IconRows>
+    friend class ST7565_Panel;
+
 private:
-    void ST7565_write(uint8_t data);
     void ST7565_send_command(uint8_t command);
     void ST7565_send_data(uint8_t data);
     void LCD_SetPage(uint8_t page);
     void LCD_SetColumn(uint8_t column);
+    void LCD_SetPageColumn(uint8_t page, uint8_t column);
+    uint8_t LCD_AddressCommands(uint8_t page, uint8_t column, uint8_t *commands);
+    bool LCD_CommandShadowed(uint8_t command, uint8_t *shadow);
+    bool LCD_InitStepRun(uint16_t *delayMs);
+    void LCD_InitFinish(void);
+    void LCD_InitFirstFrame(void);
+    bool LCD_InitReady(void);
+    void LCD_ShadowAdvance(uint16_t len);
+    void LCD_FrameStart(void);
+    void LCD_IconDirty(uint8_t first, uint8_t last);
+    void LCD_ScrollClear(uint8_t first, uint8_t count);
+    void LCD_FillLines(int16_t x0, int16_t x1, int16_t y0, int16_t y1, uint8_t colour);
+    bool LCD_IconWrite(uint8_t icon, uint8_t state);
+
+    /*!
+        @brief Set, clear or invert one pixel of a buffer byte
+        @param target buffer byte holding the pixel
+        @param bit pixel row inside the byte, 0-7
+        @param colour FOREGROUND, BACKGROUND or COLORINVERSE
+        @note A buffer in the SRAM bit-band window is written through the
+        alias, one store per pixel instead of a byte read-modify-write.
+     */
+    inline void LCD_PixelWrite(uint8_t *target, uint8_t bit, uint8_t colour)
+    {
+#ifndef LCD_BITBAND_OFF
+        uintptr_t offset = (uintptr_t)target - SRAM_BASE;
+        if (_bitBand && offset < LCD_BITBAND_SRAM_SIZE)
+        {
+            volatile uint32_t *alias = (volatile uint32_t *)(SRAM_BB_BASE + (offset << 5) + (bit << 2));
+            switch (colour)
+            {
+            case FOREGROUND:
+                *alias = 1;
+                break;
+            case BACKGROUND:
+                *alias = 0;
+                break;
+            case COLORINVERSE:
+                *alias ^= 1;
+                break;
+            }
+            return;
+        }
+#endif
+        switch (colour)
+        {
+        case FOREGROUND:
+            *target |= (1 << bit);
+            break;
+        case BACKGROUND:
+            *target &= ~(1 << bit);
+            break;
+        case COLORINVERSE:
+            *target ^= (1 << bit);
+            break;
+        }
+    }
+    void LCD_AsyncStart(LCD_UpdateCallback_t callback);
+    bool LCD_AsyncNextRow(void);
+    bool LCD_DirtyRowNext(void);
+    bool LCD_RegionSpanNext(uint8_t row, int16_t *from, int16_t *to);
+    void LCD_RegionBounds(const LCD_Rect_t &rect, int16_t *x0, int16_t *x1, int16_t *row0, int16_t *row1);
+
+    /*! @brief Whether a buffer row lies in [row0, row1), which runs past the last row after scrolling */
+    inline bool LCD_RegionRowHit(int16_t row, int16_t row0, int16_t row1)
+    {
+        return (row >= row0 && row < row1) || (row + LCD_DIRTY_ROWS >= row0 && row + LCD_DIRTY_ROWS < row1);
+    }
+    template <uint8_t Rotation>
+    void LCD_PixelRotated(int16_t x, int16_t y, uint8_t colour);
+    void LCD_PixelTransposed(int16_t x, int16_t y, uint8_t colour);
+    void LCD_TransposeFill(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour);
+    void LCD_DirtyTrim(uint8_t row, int16_t from, int16_t to);
+    void LCD_DirtyMergeBack(void);
+    LCD_Return_Codes_e LCD_ListAdd(uint8_t op, uint8_t colour, uint8_t bg, int16_t a, int16_t b, int16_t c, int16_t d, const void *data);
+    void LCD_ListReplay(uint8_t page);
+    bool LCD_DiffRun(void);
+    bool LCD_DiffShadowRun(const uint8_t *data, uint16_t n, uint16_t *start, uint16_t *end);
+    bool LCD_DiffHashRun(uint16_t n, uint16_t *start, uint16_t *end, uint16_t *next);
+    bool LCD_ChunkUpdate(int16_t column);
+    uint32_t LCD_ChunkHash(const uint8_t *data, uint8_t len);
+    void LCD_AsyncStartPage(void);
+    void LCD_AsyncFinish(void);
     // void ST7565_gpio_init(gpio_pin_t *pins, size_t num_pins);
 
-    LcdDataPin _LCD_CS;
-    LcdDataPin _LCD_RST;
-    LcdDataPin _LCD_DC;
-    LcdDataPin _LCD_WR;
-    LcdDataPin _LCD_RD;
-    LcdDataPin *_dataPins;
+    ST7565_Bus *_bus;                                   /**< controller transport backend */
+    LCD_BusTiming_t _busTiming = LCD_BusTiming_ST7565P; /**< 8080 write cycle timing in ns */
+
+    /*! Last state written to the controller, LCD_SHADOW_UNKNOWN until the first write */
+    struct ControllerShadow
+    {
+        uint8_t page;      /**< page address */
+        uint8_t column;    /**< column pointer, follows the auto-increment */
+        uint8_t contrast;  /**< electronic volume 0-63 */
+        uint8_t display;   /**< CMD_DISPLAY_ON or CMD_DISPLAY_OFF */
+        uint8_t mode;      /**< CMD_SET_DISP_NORMAL or CMD_SET_DISP_REVERSE */
+        uint8_t allPoints; /**< CMD_SET_ALLPTS_NORMAL or CMD_SET_ALLPTS_ON */
+        uint8_t power;     /**< CMD_SET_POWER_CONTROL | VB VR VF */
+        uint8_t startLine; /**< CMD_SET_DISP_START_LINE | line */
+    } _shadow = {LCD_SHADOW_UNKNOWN, LCD_SHADOW_UNKNOWN, LCD_SHADOW_UNKNOWN, LCD_SHADOW_UNKNOWN,
+                 LCD_SHADOW_UNKNOWN, LCD_SHADOW_UNKNOWN, LCD_SHADOW_UNKNOWN, LCD_SHADOW_UNKNOWN};
+    uint32_t _elidedBytes = 0; /**< command bytes skipped since the last frame started */
+
+    // 脏列范围，min > max 表示该行未修改
+    uint8_t _dirtyMin[LCD_DIRTY_ROWS];                    /**< first changed column per buffer row */
+    uint8_t _dirtyMax[LCD_DIRTY_ROWS];                    /**< last changed column per buffer row */
+    uint8_t _iconDirtyMin = 0xFF;                         /**< first changed column of the icon row */
+    uint8_t _iconDirtyMax = 0;                            /**< last changed column of the icon row */
+    const LCD_IconDesc_t *_iconTable = LCD_IconTable_Default; /**< icon descriptors, see LCDIconTableSet */
+    uint8_t _iconCount = LCD_ICON_COUNT;                      /**< entries in _iconTable */
+    const ST7565_Parallel_Screen *_dirtyScreen = nullptr; /**< screen the glass was last written from */
+    int16_t _dirtyXoffset = 0;                            /**< its xoffset at that time */
+    int16_t _dirtyYoffset = 0;                            /**< its yoffset at that time */
+    uint32_t _updateBytes = 0;                            /**< data bytes sent by the last frame */
+
+    // 双缓冲：绘图写后台（屏幕对象自己的缓冲区），刷新发送前台
+    ST7565_Parallel_Screen *_frontScreen = nullptr; /**< screen with a front buffer, nullptr single buffered */
+    uint8_t *_frontBuffer = nullptr;                /**< buffer the updates send */
+    bool _copyBack = true;                          /**< LCDswap copies the drawn columns into the new back buffer */
+    uint8_t _backDirtyMin[LCD_DIRTY_ROWS];          /**< first column drawn since the last swap */
+    uint8_t _backDirtyMax[LCD_DIRTY_ROWS];          /**< last column drawn since the last swap */
+    uint8_t *_drawDirtyMin = _dirtyMin;             /**< ranges drawPixel extends, _dirtyMin or _backDirtyMin */
+    uint8_t *_drawDirtyMax = _dirtyMax;             /**< ranges drawPixel extends, _dirtyMax or _backDirtyMax */
+
+    // 分页条带模式：绘图命令记入显示列表，刷新时逐页重放到一页宽的条带
+    LCD_ListItem_t *_list = nullptr; /**< display list set by LCDStripBegin */
+    uint16_t _listSize = 0;          /**< items the list can hold */
+    uint16_t _listLength = 0;        /**< items recorded */
+    uint8_t *_strip = nullptr;       /**< one page, _widthScreen bytes */
+    uint8_t _stripPage = 0;          /**< page drawPixel renders into during a replay */
+    bool _stripReplay = false;       /**< drawPixel writes the strip instead of ActiveBuffer */
+    bool _bitBand = true;            /**< pixel writes use the SRAM bit-band alias when the buffer is in it */
+    uint8_t _scrollLine = 0;         /**< controller start line, buffer line of the top screen row */
+
+    void (ST7565_Parallel::*_pixelWriter)(int16_t, int16_t, uint8_t); /**< drawPixel for the current rotation, set by setRotation */
+
+    // 竖屏转置模式：绘图写竖屏缓冲区，刷新前按 8x8 块转置回面板页序
+    uint8_t *_transposeBuffer = nullptr;               /**< portrait buffer, nullptr when rotation is done per pixel */
+    LCD_rotate_e _transposeRotation = LCD_Degrees_90;  /**< LCD_Degrees_90 or LCD_Degrees_270 */
+    uint8_t _transposeDirty[LCD_TRANSPOSE_PAGES] = {}; /**< per portrait page, one bit per 8 column block drawn */
+    uint16_t _transposeBlocks = 0;                     /**< blocks the last flush transposed */
+
+    LCD_DiffMode_e _diffMode = LCD_Diff_Off;    /**< change detection inside the dirty columns */
+    uint8_t *_diffShadow = nullptr;             /**< copy of the glass, display pages then the icon row */
+    uint32_t *_diffHash = nullptr;              /**< CRC-32 per chunk as last sent, LCD_CHUNKS_PER_PAGE per page */
+    bool _diffValid = false;                    /**< the shadow or the chunk hashes match the glass */
+    uint8_t _diffMergeGap = LCD_DIFF_MERGE_GAP; /**< unchanged bytes joining two runs */
+    uint32_t _diffSavedBytes = 0;               /**< dirty bytes the last frame did not send */
+    uint32_t _diffChunks = 0;                   /**< chunks hashed in the last frame */
+    uint32_t _diffChunkHits = 0;                /**< of those, chunks that matched */
+
+    const LCD_Rect_t *_regionRects = nullptr; /**< rectangles of the running LCDupdateRegions */
+    uint8_t _regionCount = 0;                 /**< 0 when the row walk follows the dirty ranges */
+    int16_t _regionColumn = 0;                /**< buffer column the next region span starts from */
+
+    volatile bool _asyncBusy = false;            /**< an asynchronous update is running */
+    uint8_t _asyncRow = 0;                       /**< next buffer row (page) to send, height/8 = icon row */
+    LCD_UpdateCallback_t _asyncCallback = nullptr; /**< called when the frame is out */
+    volatile bool _updateComplete = false;       /**< set when an asynchronous frame is out, cleared by LCDupdateComplete */
+
+    /*! Current row of an asynchronous update */
+    struct AsyncRow
+    {
+        const uint8_t *data; /**< first byte to send */
+        uint16_t len;        /**< bytes in the row */
+        uint8_t page;        /**< controller page address */
+        uint8_t column;      /**< controller column address */
+    } _asyncCur = {nullptr, 0, 0, 0};
+
+    /*! Dirty columns of the current row not yet compared or sent */
+    struct AsyncSpan
+    {
+        const uint8_t *data;  /**< buffer byte of column 0 of the row */
+        uint16_t from;        /**< first buffer column left */
+        uint16_t to;          /**< end of the span, exclusive */
+        uint16_t visibleFrom; /**< first buffer column on the glass */
+        uint16_t visibleTo;   /**< end of the visible columns, exclusive */
+        uint8_t page;         /**< controller page address */
+        int16_t column;       /**< controller column of buffer column 0 */
+    } _asyncSpan = {nullptr, 0, 0, 0, 0, 0, 0};
+
+    /*! Progress of the power-on sequence */
+    enum InitState : uint8_t
+    {
+        InitIdle,    /**< not started */
+        InitRunning,      /**< LCDinitTick walks the table */
+        InitFramePending, /**< commands are out, the first frame waits for the main loop */
+        InitDone,         /**< first frame is out */
+    };
+    const LCD_InitStep_t *_initTable = LCD_InitTable_ST7565P; /**< power-on sequence */
+    uint8_t _initStep = 0;                                    /**< next table entry */
+    uint16_t _initWaitMs = 0;                                 /**< SysTick ticks left before the next step */
+    volatile InitState _initState = InitIdle;
+    uint32_t _initStartTick = 0; /**< HAL tick at LCDbegin/LCDbeginAsync */
+    uint32_t _firstFrameMs = 0;  /**< time from begin to the first frame */
+
+    bool _itActive = false;          /**< LCDrefreshTick drives the current frame */
+    uint16_t _itBytesPerTick = 8;    /**< bus bytes emitted per tick, commands included */
+    uint8_t _itCommand = 0;          /**< address bytes of the current row already sent */
+    uint8_t _itPreamble[3];          /**< address commands of the current row, shadowed */
+    uint8_t _itPreambleLen = 0;      /**< bytes in _itPreamble, _itCommand == _itPreambleLen is the data phase */
+    uint16_t _itSent = 0;            /**< data bytes of the current row already sent */
+    TIM_TypeDef *_itTimer = nullptr; /**< timer set up by LCDrefreshTimerBegin */
+    uint32_t _itMaxTickCycles = 0;   /**< longest LCDrefreshTick in CPU cycles */
 
     static const uint8_t _VbiasPOT = 0x20;                        /**< Contrast default 0x49 datasheet 00-FE */
     static const uint8_t _AddressCtrl = 0x04;                     /**< Set AC [2:0] Program registers  for RAM address control. 0x00 to 0x07*/
@@ -212,6 +652,8 @@ private:
     uint8_t _heightScreen = 64; /**< Height of screen in pixels */
     uint16_t _bufferSize = _widthScreen * (_heightScreen / 8);
     uint8_t *_InactiveBuffer;
+    bool _ownsBus = false;        /**< _bus was created by the pin list constructor */
+    bool _ownsIconBuffer = false; /**< _InactiveBuffer came from the heap */
     static const uint8_t _iconwidthScreen = 128; /**< Width of screen in pixels */
     static const uint8_t _iconheightScreen = 8;  /**< Height of screen in pixels */
 };
@@ -0,0 +1,120 @@
+/*!
+    @file ST7565_SpiPort.h
+    @brief SPI hardware behind the 4-wire serial ST7565 bus backend.
+    @details ST7565_SpiPort covers the line and byte level work (CS, A0,
+    RST, polled bytes and DMA bursts), so the command/data sequencing in
+    ST7565_Bus_Spi can run against a host-side stand-in. ST7565_SpiPort_Hw
+    is the STM32F1 implementation: SPI in transmit-only master mode, mode 3
+    (the controller latches SI on the rising edge of SCL), TX fed by a DMA1
+    channel for data bursts.
+*/
+
+#ifndef ST7565_SPIPORT_H
+#define ST7565_SPIPORT_H
+
+#include "stm32f1xx_hal.h"
+#include "ST7565_DataBus.h"
+
+#define LCD_SPI_MAX_HZ 20000000U  /**< ST7565P serial clock limit, tSCYC >= 50 ns */
+#define LCD_SPI_DMA_MIN_BURST 16  /**< shorter runs are written by polling, DMA setup costs more */
+
+/*! @brief Hardware interface used by ST7565_Bus_Spi */
+class ST7565_SpiPort
+{
+public:
+    virtual ~ST7565_SpiPort() {};
+
+    /*!
+        @brief Configure the pins, the SPI and the DMA channel
+        @param maxHz fastest allowed SCL, the port picks the nearest clock at or below it
+        @return false if the configuration cannot be used
+     */
+    virtual bool begin(uint32_t maxHz) = 0;
+    /*!
+        @brief Getter for the SCL frequency chosen in begin
+        @return Hz
+     */
+    virtual uint32_t getClockHz(void) = 0;
+    /*!
+        @brief Drive the controller reset line
+        @param active true holds the controller in reset
+     */
+    virtual void reset(bool active) = 0;
+    /*!
+        @brief Drive CS1
+        @param active true selects the controller
+     */
+    virtual void select(bool active) = 0;
+    /*!
+        @brief Drive A0
+        @param data true for display data, false for commands
+     */
+    virtual void setA0(bool data) = 0;
+    /*!
+        @brief Clock bytes out and wait until the last bit has left the shifter
+        @param data bytes to send
+        @param len number of bytes
+        @param step 1 walks through data, 0 repeats data[0] len times
+     */
+    virtual void write(const uint8_t *data, uint16_t len, uint8_t step) = 0;
+    /*!
+        @brief Start a DMA burst, CS and A0 are already set
+        @param data bytes to send, must stay valid until complete() returns true
+        @param len number of bytes
+        @param step 1 walks through data, 0 repeats data[0] len times
+        @param interrupt true enables the transfer complete interrupt
+     */
+    virtual void start(const uint8_t *data, uint16_t len, uint8_t step, bool interrupt) = 0;
+    /*!
+        @brief Acknowledge the end of a DMA burst
+        @return true once the burst has finished and the shifter is idle
+     */
+    virtual bool complete(void) = 0;
+};
+
+/*! SPI and DMA channel wiring for ST7565_SpiPort_Hw */
+typedef struct
+{
+    SPI_TypeDef *spi;         /**< SPI1 (APB2) or SPI2 (APB1) */
+    DMA_Channel_TypeDef *dma; /**< DMA1 channel mapped to SPI TX */
+    IRQn_Type dmaIRQn;        /**< interrupt of that DMA channel */
+    LcdDataPin sck;           /**< SCL */
+    LcdDataPin mosi;          /**< SI */
+} LCD_SpiConfig_t;
+
+/*! SPI1: SCL on PA5, SI on PA7, TX on DMA1 channel 3 */
+static const LCD_SpiConfig_t LCD_SpiConfig_SPI1 = {
+    SPI1, DMA1_Channel3, DMA1_Channel3_IRQn, {GPIOA, GPIO_PIN_5}, {GPIOA, GPIO_PIN_7}};
+
+/*! SPI2: SCL on PB13, SI on PB15, TX on DMA1 channel 5 */
+static const LCD_SpiConfig_t LCD_SpiConfig_SPI2 = {
+    SPI2, DMA1_Channel5, DMA1_Channel5_IRQn, {GPIOB, GPIO_PIN_13}, {GPIOB, GPIO_PIN_15}};
+
+/*! @brief STM32F1 SPI + DMA1 implementation of ST7565_SpiPort */
+class ST7565_SpiPort_Hw : public ST7565_SpiPort
+{
+public:
+    ST7565_SpiPort_Hw(const LCD_SpiConfig_t &config, LcdDataPin cs, LcdDataPin rst, LcdDataPin a0);
+
+    virtual bool begin(uint32_t maxHz) override;
+    virtual uint32_t getClockHz(void) override;
+    virtual void reset(bool active) override;
+    virtual void select(bool active) override;
+    virtual void setA0(bool data) override;
+    virtual void write(const uint8_t *data, uint16_t len, uint8_t step) override;
+    virtual void start(const uint8_t *data, uint16_t len, uint8_t step, bool interrupt) override;
+    virtual bool complete(void) override;
+
+private:
+    void waitIdle(void);
+
+    LCD_SpiConfig_t _config;
+    LcdDataPin _LCD_CS;
+    LcdDataPin _LCD_RST;
+    LcdDataPin _LCD_A0;
+    uint32_t _clockHz = 0;
+    uint8_t _dmaIndex = 0; /**< DMA1 channel number - 1, for the ISR/IFCR flags */
+    uint8_t _fill = 0;     /**< repeated byte of a step 0 burst, the DMA source */
+};
+
+#endif // ST7565_SPIPORT_H
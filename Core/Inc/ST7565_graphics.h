@@ -44,6 +44,13 @@ enum LCD_Return_Codes_e : uint8_t
     LCD_BitmapLargerThanScreen = 9, /**< The Bitmap is larger than screen , check  w and h*/
     LCD_BitmapVerticalSize = 10,    /**< A vertical  Bitmap's height must be divisible by 8. */
     LCD_BitmapHorizontalSize = 11,  /**< A horizontal Bitmap's width  must be divisible by 8  */
+    LCD_BusBusy = 12,               /**< An asynchronous update is still in progress */
+    LCD_BusUnsupported = 13,        /**< The bus backend or pin map does not support this transfer mode */
+    LCD_ListFull = 14,              /**< The strip mode display list has no room for another item */
+    LCD_IconRange = 15,             /**< Icon index or state outside the icon table */
+    LCD_ScrollRange = 16,           /**< Scrolling needs a full height (64 row) screen at y offset 0 */
+    LCD_TransposeRange = 17,        /**< Transposed rotation needs 90 or 270 degrees, a full screen in whole 8x8 blocks and no scrolling */
+    LCD_ScreenNullptr = 18,         /**< ActiveBuffer is not set */
 };
 
 /*! LCD Enum to define current font type selected  */
@@ -63,9 +70,15 @@ enum LCD_Font_Type_e : uint8_t
     UC1609Font_Dedica = 12     /**< Dedica font */
 };
 
+template <class Derived>
+class ST7565_graphics_t;
+
 /*! @brief Graphics class to hold graphic related functions */
 class ST7565_graphics
 {
+    // 静态分派版本调用下面的图元模板
+    template <class Derived>
+    friend class ST7565_graphics_t;
 
 public:
     ST7565_graphics(int16_t w, int16_t h);
@@ -75,12 +88,12 @@ public:
     virtual void drawPixel(int16_t x, int16_t y, uint8_t color) = 0;
     // 绘制直线
     void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color);
-    // 绘制一个填充矩形
-    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
-    // 绘制一条垂直线的函数声明
-    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint8_t color);
-    // 绘制水平线
-    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint8_t color);
+    // 绘制一个填充矩形，子类可按整字节填充覆盖
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
+    // 绘制一条垂直线的函数声明，子类可按整字节填充覆盖
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint8_t color);
+    // 绘制水平线，子类可按整字节填充覆盖
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint8_t color);
     // 绘制矩形
     void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
     // 填充整个屏幕
@@ -113,6 +126,7 @@ public:
     void setTextSize(uint8_t s);
     void setTextWrap(bool w);
     void setFontNum(LCD_Font_Type_e FontNumber);
+    LCD_Font_Type_e getFontNum(void);
     LCD_Return_Codes_e drawChar(uint8_t x, uint8_t y, uint8_t c, uint8_t color, uint8_t bg);
     LCD_Return_Codes_e drawText(uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg);
     LCD_Return_Codes_e drawChar(int16_t x, int16_t y, unsigned char c, uint8_t color, uint8_t bg, uint8_t s);
@@ -123,7 +137,8 @@ public:
     // Screen related
     int16_t height(void) const;
     int16_t width(void) const;
-    void setRotation(LCD_rotate_e);
+    // 子类可按旋转方向重新选择像素写入函数
+    virtual void setRotation(LCD_rotate_e);
     LCD_rotate_e getRotation(void);
 
 protected:
@@ -189,6 +204,34 @@ private:
     uint8_t _CurrentFontoffset = 0;   /**< Store current offset width */
     uint8_t _CurrentFontheight = 8;   /**< Store current offset height */
     uint8_t _CurrentFontLength = 128; /**< Store current font number of characters */
+
+    const uint8_t *LCD_FontColumns(unsigned char character);
+
+    // 图元算法只有一份，按像素接收器模板化，定义见 ST7565_graphics_t.h
+    template <class Sink>
+    void LCD_DrawLine(Sink &sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color);
+    template <class Sink>
+    void LCD_DrawRect(Sink &sink, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
+    template <class Sink>
+    void LCD_DrawCircle(Sink &sink, int16_t x0, int16_t y0, int16_t r, uint8_t color);
+    template <class Sink>
+    void LCD_DrawCircleHelper(Sink &sink, int16_t x0, int16_t y0, int16_t r, uint8_t cornername, uint8_t color);
+    template <class Sink>
+    void LCD_FillCircle(Sink &sink, int16_t x0, int16_t y0, int16_t r, uint8_t color);
+    template <class Sink>
+    void LCD_FillCircleHelper(Sink &sink, int16_t x0, int16_t y0, int16_t r, uint8_t cornername, int16_t delta, uint8_t color);
+    template <class Sink>
+    void LCD_DrawTriangle(Sink &sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color);
+    template <class Sink>
+    void LCD_FillTriangle(Sink &sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color);
+    template <class Sink>
+    void LCD_DrawRoundRect(Sink &sink, int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color);
+    template <class Sink>
+    void LCD_FillRoundRect(Sink &sink, int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color);
+    template <class Sink>
+    LCD_Return_Codes_e LCD_DrawChar(Sink &sink, int16_t x, int16_t y, unsigned char character, uint8_t color, uint8_t bg, uint8_t size);
+    template <class Sink>
+    LCD_Return_Codes_e LCD_DrawText(Sink &sink, uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg, uint8_t size);
 };
 
 #endif
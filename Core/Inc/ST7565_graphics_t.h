@@ -0,0 +1,548 @@
+/*!
+    @file ST7565_graphics_t.h
+    @brief Graphics primitives templated on the pixel sink, and the CRTP
+    front end that binds drawPixel at compile time.
+    @details The line, rectangle, circle, triangle and text algorithms exist
+    once, as the ST7565_graphics::LCD_Draw... member templates defined here.
+    A sink provides drawPixel, drawFastVLine, drawFastHLine and fillRect:
+    ST7565_graphics passes itself, so every pixel goes through the vtable;
+    ST7565_graphics_t<Derived> checks the rotation once per primitive and
+    passes a sink bound to Derived's writer for that rotation, so the
+    compiler can inline the pixel writer into the primitive's inner loop.
+    Derived must also be an ST7565_graphics (the font and rotation state
+    live there) and, because both bases name the same primitives, must pick
+    the ones it exports with using-declarations, see ST7565_Panel.
+    A Derived object used through an ST7565_graphics reference still takes
+    the virtual path.
+*/
+
+#ifndef ST7565_GRAPHICS_T_H
+#define ST7565_GRAPHICS_T_H
+
+#include "ST7565_graphics.h"
+
+/*!
+    @brief draws a line from (x0,y0) to (x1,y1), Bresenham
+    @param sink receives the pixels
+    @param color colour of the line
+ */
+template <class Sink>
+void ST7565_graphics::LCD_DrawLine(Sink &sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color)
+{
+    int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep)
+    {
+        ST7565_swap(x0, y0);
+        ST7565_swap(x1, y1);
+    }
+
+    if (x0 > x1)
+    {
+        ST7565_swap(x0, x1);
+        ST7565_swap(y0, y1);
+    }
+
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = (y0 < y1) ? 1 : -1;
+
+    for (; x0 <= x1; x0++)
+    {
+        if (steep)
+        {
+            sink.drawPixel(y0, x0, color);
+        }
+        else
+        {
+            sink.drawPixel(x0, y0, color);
+        }
+        err -= dy;
+        if (err < 0)
+        {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_DrawRect(Sink &sink, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color)
+{
+    sink.drawFastHLine(x, y, w, color);
+    sink.drawFastHLine(x, y + h - 1, w, color);
+    sink.drawFastVLine(x, y, h, color);
+    sink.drawFastVLine(x + w - 1, y, h, color);
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_DrawCircle(Sink &sink, int16_t x0, int16_t y0, int16_t r, uint8_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    sink.drawPixel(x0, y0 + r, color);
+    sink.drawPixel(x0, y0 - r, color);
+    sink.drawPixel(x0 + r, y0, color);
+    sink.drawPixel(x0 - r, y0, color);
+
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        sink.drawPixel(x0 + x, y0 + y, color);
+        sink.drawPixel(x0 - x, y0 + y, color);
+        sink.drawPixel(x0 + x, y0 - y, color);
+        sink.drawPixel(x0 - x, y0 - y, color);
+        sink.drawPixel(x0 + y, y0 + x, color);
+        sink.drawPixel(x0 - y, y0 + x, color);
+        sink.drawPixel(x0 + y, y0 - x, color);
+        sink.drawPixel(x0 - y, y0 - x, color);
+    }
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_DrawCircleHelper(Sink &sink, int16_t x0, int16_t y0, int16_t r, uint8_t cornername, uint8_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        if (cornername & 0x4)
+        {
+            sink.drawPixel(x0 + x, y0 + y, color);
+            sink.drawPixel(x0 + y, y0 + x, color);
+        }
+        if (cornername & 0x2)
+        {
+            sink.drawPixel(x0 + x, y0 - y, color);
+            sink.drawPixel(x0 + y, y0 - x, color);
+        }
+        if (cornername & 0x8)
+        {
+            sink.drawPixel(x0 - y, y0 + x, color);
+            sink.drawPixel(x0 - x, y0 + y, color);
+        }
+        if (cornername & 0x1)
+        {
+            sink.drawPixel(x0 - y, y0 - x, color);
+            sink.drawPixel(x0 - x, y0 - y, color);
+        }
+    }
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_FillCircle(Sink &sink, int16_t x0, int16_t y0, int16_t r, uint8_t color)
+{
+    sink.drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+    LCD_FillCircleHelper(sink, x0, y0, r, 3, 0, color);
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_FillCircleHelper(Sink &sink, int16_t x0, int16_t y0, int16_t r, uint8_t cornername, int16_t delta, uint8_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        if (cornername & 0x1)
+        {
+            sink.drawFastVLine(x0 + x, y0 - y, 2 * y + 1 + delta, color);
+            sink.drawFastVLine(x0 + y, y0 - x, 2 * x + 1 + delta, color);
+        }
+        if (cornername & 0x2)
+        {
+            sink.drawFastVLine(x0 - x, y0 - y, 2 * y + 1 + delta, color);
+            sink.drawFastVLine(x0 - y, y0 - x, 2 * x + 1 + delta, color);
+        }
+    }
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_DrawTriangle(Sink &sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color)
+{
+    LCD_DrawLine(sink, x0, y0, x1, y1, color);
+    LCD_DrawLine(sink, x1, y1, x2, y2, color);
+    LCD_DrawLine(sink, x2, y2, x0, y0, color);
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_FillTriangle(Sink &sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color)
+{
+    int16_t a, b, y, last;
+
+    if (y0 > y1)
+    {
+        ST7565_swap(y0, y1);
+        ST7565_swap(x0, x1);
+    }
+    if (y1 > y2)
+    {
+        ST7565_swap(y2, y1);
+        ST7565_swap(x2, x1);
+    }
+    if (y0 > y1)
+    {
+        ST7565_swap(y0, y1);
+        ST7565_swap(x0, x1);
+    }
+
+    if (y0 == y2)
+    {
+        a = b = x0;
+        if (x1 < a)
+            a = x1;
+        else if (x1 > b)
+            b = x1;
+        if (x2 < a)
+            a = x2;
+        else if (x2 > b)
+            b = x2;
+        sink.drawFastHLine(a, y0, b - a + 1, color);
+        return;
+    }
+
+    int16_t dx01 = x1 - x0, dy01 = y1 - y0;
+    int16_t dx02 = x2 - x0, dy02 = y2 - y0;
+    int16_t dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+
+    last = (y1 == y2) ? y1 : y1 - 1;
+
+    for (y = y0; y <= last; y++)
+    {
+        a = x0 + sa / dy01;
+        b = x0 + sb / dy02;
+        sa += dx01;
+        sb += dx02;
+        if (a > b)
+            ST7565_swap(a, b);
+        sink.drawFastHLine(a, y, b - a + 1, color);
+    }
+
+    sa = dx12 * (y - y1);
+    sb = dx02 * (y - y0);
+    for (; y <= y2; y++)
+    {
+        a = x1 + sa / dy12;
+        b = x0 + sb / dy02;
+        sa += dx12;
+        sb += dx02;
+        if (a > b)
+            ST7565_swap(a, b);
+        sink.drawFastHLine(a, y, b - a + 1, color);
+    }
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_DrawRoundRect(Sink &sink, int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color)
+{
+    sink.drawFastHLine(x + r, y, w - 2 * r, color);         // Top
+    sink.drawFastHLine(x + r, y + h - 1, w - 2 * r, color); // Bottom
+    sink.drawFastVLine(x, y + r, h - 2 * r, color);         // Left
+    sink.drawFastVLine(x + w - 1, y + r, h - 2 * r, color); // Right
+    // draw four corners
+    LCD_DrawCircleHelper(sink, x + r, y + r, r, 1, color);
+    LCD_DrawCircleHelper(sink, x + w - r - 1, y + r, r, 2, color);
+    LCD_DrawCircleHelper(sink, x + w - r - 1, y + h - r - 1, r, 4, color);
+    LCD_DrawCircleHelper(sink, x + r, y + h - r - 1, r, 8, color);
+}
+
+template <class Sink>
+void ST7565_graphics::LCD_FillRoundRect(Sink &sink, int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color)
+{
+    sink.fillRect(x + r, y, w - 2 * r, h, color);
+    LCD_FillCircleHelper(sink, x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+    LCD_FillCircleHelper(sink, x + r, y + r, r, 2, h - 2 * r - 1, color);
+}
+
+/*!
+    @brief writes a char of font 1-6
+    @param size text size, > 1 draws each bit with the sink's fillRect
+    @return LCD_Success or the error from the checks
+ */
+template <class Sink>
+LCD_Return_Codes_e ST7565_graphics::LCD_DrawChar(Sink &sink, int16_t x, int16_t y, unsigned char character, uint8_t color, uint8_t bg, uint8_t size)
+{
+    // 1. Check for wrong font
+    if (_FontNumber >= UC1609Font_Bignum)
+    {
+        return LCD_WrongFont;
+    }
+    // 2. Check for screen out of  bounds
+    if ((x >= _width) ||                                  // Clip right
+        (y >= _height) ||                                 // Clip bottom
+        ((x + (_CurrentFontWidth + 1) * size - 1) < 0) || // Clip left
+        ((y + _CurrentFontheight * size - 1) < 0))        // Clip top
+    {
+        return LCD_CharScreenBounds;
+    }
+    // 3. Check for character out of font range bounds
+    if (character < _CurrentFontoffset || character >= (_CurrentFontLength + _CurrentFontoffset))
+    {
+        return LCD_CharFontASCIIRange;
+    }
+    const uint8_t *columns = LCD_FontColumns(character);
+    if (columns == nullptr)
+    {
+        return LCD_WrongFont;
+    }
+
+    // 字体状态在循环前取出，循环内只剩像素写入
+    const uint8_t width = _CurrentFontWidth;
+    const uint8_t height = _CurrentFontheight;
+    for (int8_t i = 0; i < (width + 1); i++)
+    {
+        uint8_t line = (i == width) ? 0x0 : pgm_read_byte(columns + i);
+        for (int8_t j = 0; j < height; j++)
+        {
+            if (line & 0x1)
+            {
+                if (size == 1)
+                    sink.drawPixel(x + i, y + j, color);
+                else
+                    sink.fillRect(x + (i * size), y + (j * size), size, size, color);
+            }
+            else if (bg != color)
+            {
+                if (size == 1)
+                    sink.drawPixel(x + i, y + j, bg);
+                else
+                    sink.fillRect(x + i * size, y + j * size, size, size, bg);
+            }
+            line >>= 1;
+        }
+    }
+    return LCD_Success;
+}
+
+/*!
+    @brief writes a string of font 1-6, wrapping at the right edge
+    @return LCD_Success or the first error from LCD_DrawChar
+ */
+template <class Sink>
+LCD_Return_Codes_e ST7565_graphics::LCD_DrawText(Sink &sink, uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg, uint8_t size)
+{
+    // check Correct font number
+    if (_FontNumber >= UC1609Font_Bignum)
+    {
+        return LCD_WrongFont;
+    }
+    // Check for null pointer
+    if (pText == nullptr)
+    {
+        return LCD_CharArrayNullptr;
+    }
+
+    uint8_t lcursorX = x;
+    uint8_t lcursorY = y;
+    while (*pText != '\0')
+    {
+        if (_textWrap && ((lcursorX + size * _CurrentFontWidth) > _width))
+        {
+            lcursorX = 0;
+            lcursorY = lcursorY + size * 7 + 3;
+            if (lcursorY > _height)
+                lcursorY = _height;
+        }
+        LCD_Return_Codes_e DrawCharReturnCode = LCD_DrawChar(sink, lcursorX, lcursorY, *pText, color, bg, size);
+        if (DrawCharReturnCode != LCD_Success)
+        {
+            return DrawCharReturnCode;
+        }
+        lcursorX = lcursorX + size * (_CurrentFontWidth + 1);
+        if (lcursorX > _width)
+            lcursorX = _width;
+        pText++;
+    }
+    return LCD_Success;
+}
+
+/*!
+    @brief Statically dispatched graphics primitives
+    @tparam Derived the display class, provides drawPixel, drawFastVLine,
+        drawFastHLine and fillRect, plus LCD_PanelDirect and the writer
+        template LCD_PanelPixel<Rotation>
+ */
+template <class Derived>
+class ST7565_graphics_t
+{
+public:
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_DrawLine(sink, x0, y0, x1, y1, color); });
+    }
+
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_DrawRect(sink, x, y, w, h, color); });
+    }
+
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_DrawCircle(sink, x0, y0, r, color); });
+    }
+
+    void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_DrawCircleHelper(sink, x0, y0, r, cornername, color); });
+    }
+
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_FillCircle(sink, x0, y0, r, color); });
+    }
+
+    void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, int16_t delta, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_FillCircleHelper(sink, x0, y0, r, cornername, delta, color); });
+    }
+
+    void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_DrawTriangle(sink, x0, y0, x1, y1, x2, y2, color); });
+    }
+
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_FillTriangle(sink, x0, y0, x1, y1, x2, y2, color); });
+    }
+
+    void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_DrawRoundRect(sink, x, y, w, h, r, color); });
+    }
+
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color)
+    {
+        LCD_Rotated([&](auto &sink) { return self().LCD_FillRoundRect(sink, x, y, w, h, r, color); });
+    }
+
+    LCD_Return_Codes_e drawChar(int16_t x, int16_t y, unsigned char character, uint8_t color, uint8_t bg, uint8_t size)
+    {
+        return LCD_Rotated([&](auto &sink) { return self().LCD_DrawChar(sink, x, y, character, color, bg, size); });
+    }
+
+    LCD_Return_Codes_e drawText(uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg, uint8_t size)
+    {
+        return LCD_Rotated([&](auto &sink) { return self().LCD_DrawText(sink, x, y, pText, color, bg, size); });
+    }
+
+    // 数字字体 7-12 仍走 ST7565_graphics 的虚函数路径
+    LCD_Return_Codes_e drawChar(uint8_t x, uint8_t y, uint8_t character, uint8_t color, uint8_t bg)
+    {
+        return self().ST7565_graphics::drawChar(x, y, character, color, bg);
+    }
+
+    LCD_Return_Codes_e drawText(uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg)
+    {
+        return self().ST7565_graphics::drawText(x, y, pText, color, bg);
+    }
+
+private:
+    /*! @brief Pixel sink with qualified calls into Derived, drawPixel picks the writer per pixel */
+    struct Sink
+    {
+        Derived &lcd; /**< the display drawn into */
+
+        void drawPixel(int16_t x, int16_t y, uint8_t color) { lcd.Derived::drawPixel(x, y, color); }
+        void drawFastVLine(int16_t x, int16_t y, int16_t h, uint8_t color) { lcd.Derived::drawFastVLine(x, y, h, color); }
+        void drawFastHLine(int16_t x, int16_t y, int16_t w, uint8_t color) { lcd.Derived::drawFastHLine(x, y, w, color); }
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) { lcd.Derived::fillRect(x, y, w, h, color); }
+    };
+
+    /*! @brief Pixel sink bound to the writer of one rotation, it inlines into the primitive's loops */
+    template <uint8_t Rotation>
+    struct RotatedSink
+    {
+        Derived &lcd; /**< the display drawn into */
+
+        void drawPixel(int16_t x, int16_t y, uint8_t color) { lcd.template LCD_PanelPixel<Rotation>(x, y, color); }
+        void drawFastVLine(int16_t x, int16_t y, int16_t h, uint8_t color) { lcd.Derived::drawFastVLine(x, y, h, color); }
+        void drawFastHLine(int16_t x, int16_t y, int16_t w, uint8_t color) { lcd.Derived::drawFastHLine(x, y, w, color); }
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) { lcd.Derived::fillRect(x, y, w, h, color); }
+    };
+
+    /*!
+        @brief Run a primitive through the sink for the current rotation
+        @param draw calls the primitive with the sink it is given
+        @return what the primitive returns
+        @note LCD_PanelDirect and the rotation are checked once here, not per
+        pixel. When Derived cannot take the direct writer (another screen,
+        strip replay, transposed rotation) every pixel goes through its drawPixel.
+     */
+    template <class Draw>
+    auto LCD_Rotated(Draw draw)
+    {
+        if (!self().LCD_PanelDirect())
+        {
+            Sink sink = {self()};
+            return draw(sink);
+        }
+        switch (self().getRotation())
+        {
+        case LCD_Degrees_90:
+        {
+            RotatedSink<LCD_Degrees_90> sink = {self()};
+            return draw(sink);
+        }
+        case LCD_Degrees_180:
+        {
+            RotatedSink<LCD_Degrees_180> sink = {self()};
+            return draw(sink);
+        }
+        case LCD_Degrees_270:
+        {
+            RotatedSink<LCD_Degrees_270> sink = {self()};
+            return draw(sink);
+        }
+        default:
+        {
+            RotatedSink<LCD_Degrees_0> sink = {self()};
+            return draw(sink);
+        }
+        }
+    }
+
+    Derived &self(void) { return *static_cast<Derived *>(this); }
+};
+
+#endif // ST7565_GRAPHICS_T_H
@@ -0,0 +1,92 @@
+/*
+ * dwt_delay.h
+ *
+ *  基于 Cortex-M3 DWT CYCCNT 自由运行计数器的周期级延时。
+ *  无需每次调用配置外设，不占用 TIM2。
+ *  定义 DWT_DELAY_HOST_MOCK 时使用软件模拟计数器，可在 Linux 主机上运行。
+ */
+
+#ifndef DWT_DELAY_H
+#define DWT_DELAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef DWT_DELAY_HOST_MOCK
+#include <stdint.h>
+
+#define DWT_DELAY_HOST_CLOCK_HZ 72000000U /**< 主机模拟的内核时钟 */
+
+extern volatile uint32_t dwt_mock_cyccnt; /**< 模拟的 CYCCNT */
+extern uint32_t dwt_mock_step;            /**< 每次读取计数器时前进的周期数 */
+
+void dwt_mock_set(uint32_t cycles);
+void dwt_mock_advance(uint32_t cycles);
+#else
+#include "stm32f1xx_hal.h"
+#endif
+
+extern uint32_t dwt_cycles_per_us; /**< 由 dwt_delay_init 按内核时钟计算 */
+
+/**
+ * @brief 初始化 DWT 周期计数器
+ *
+ * 使能跟踪单元并启动 CYCCNT，系统时钟改变后需重新调用。
+ */
+void dwt_delay_init(void);
+
+/**
+ * @brief 读取当前周期计数
+ *
+ * @return CYCCNT 的值，32 位回绕
+ */
+static inline uint32_t dwt_cycles(void)
+{
+#ifdef DWT_DELAY_HOST_MOCK
+    return dwt_mock_cyccnt += dwt_mock_step;
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+/**
+ * @brief 等待计数器到达截止时刻
+ *
+ * @param deadline 截止周期数（dwt_cycles() + n），回绕安全
+ */
+static inline void wait_until(uint32_t deadline)
+{
+    while ((int32_t)(dwt_cycles() - deadline) < 0)
+    {
+    }
+}
+
+/**
+ * @brief 周期级延时函数
+ *
+ * @param cycles 延时的 CPU 周期数
+ */
+static inline void delay_cycles(uint32_t cycles)
+{
+    uint32_t start = dwt_cycles();
+    while ((dwt_cycles() - start) < cycles)
+    {
+    }
+}
+
+/**
+ * @brief 纳秒级延时函数
+ *
+ * @param ns 延时的纳秒数，向上取整到 CPU 周期
+ */
+static inline void delay_ns(uint32_t ns)
+{
+    delay_cycles((ns * dwt_cycles_per_us + 999U) / 1000U);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWT_DELAY_H */
@@ -164,7 +164,11 @@ void Error_Handler(void);
 /* Private defines -----------------------------------------------------------*/
 
 /* USER CODE BEGIN Private defines */
+// 定义显示器的宽度和高度
+#define DISPLAY_WIDTH 128
+#define DISPLAY_HEIGHT 64
 
+#define FULLSCREEN (DISPLAY_WIDTH * (DISPLAY_HEIGHT / 8)) // 1536 bytes
 /* USER CODE END Private defines */
 
 #ifdef __cplusplus
@@ -19,6 +19,7 @@ extern "C" {
  * @brief 初始化微秒延时功能
  * 
  * 在使用延时函数之前，需要先调用此函数进行初始化。
+ * 基于 DWT 周期计数器（见 dwt_delay.h），不再占用 TIM2。
  */
 void delay_us_init(void);
 
@@ -0,0 +1,273 @@
+/*!
+    @file LCD_Benchmark.cpp
+    @brief Cycle counts of the ST7565 driver paths, printed over UART1.
+    @details Built only with LCD_BENCHMARK defined. The bus benchmarks drive
+    the controller through temporary drivers; the others only draw into
+    buffers, nothing is sent to the screen.
+*/
+
+#ifdef LCD_BENCHMARK
+
+#include <stdio.h>
+#include "main.h"
+#include "dwt_delay.h"
+#include "ST7565_Panel.h"
+#include "ST7565_Bus_Recording.h"
+#include "LCD_Benchmark.h"
+
+/*!
+    @brief Draw the demo screen over a bus backend and print the LCDupdate time
+    @param name printed with the result
+    @param bus the backend under test, pins are re-initialised by LCDbegin
+    @note Resets the controller behind mylcd, call mylcd.LCDbegin afterwards.
+ */
+void LCD_BenchmarkBus(const char *name, ST7565_Bus *bus)
+{
+  ST7565_Parallel lcd(DISPLAY_WIDTH, DISPLAY_HEIGHT, bus);
+  lcd.LCDbegin();
+  lcd.ActiveBuffer = &fullScreen;
+  lcd.LCDclearBuffer();
+  char text[] = "Hello World";
+  lcd.drawText(0, 0, text, 0x01, 0x00, 1);
+  lcd.drawRect(0, 15, 64, 30, 0x01);
+  lcd.fillRect(10, 10, 20, 20, 0x01);
+
+  uint32_t start = dwt_cycles();
+  lcd.LCDupdate();
+  uint32_t cycles = dwt_cycles() - start;
+
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "bus %s: %lu cycles/frame, %lu command bytes elided\n", name, cycles, lcd.LCDElidedBytesGet());
+  UART_Print(buffer);
+}
+
+/*!
+    @brief Draw the demo screen through the display list and print the
+    LCDupdateStrip time and the RAM of both modes
+    @param bus the backend under test
+ */
+void LCD_BenchmarkStrip(ST7565_Bus *bus)
+{
+  static LCD_ListItem_t list[16];
+  static uint8_t strip[DISPLAY_WIDTH];
+  ST7565_Parallel lcd(DISPLAY_WIDTH, DISPLAY_HEIGHT, bus);
+  lcd.LCDbegin();
+  lcd.LCDStripBegin(list, 16, strip);
+  lcd.LCDListText(0, 0, "Hello World", 0x01, 0x00, 1);
+  lcd.LCDListRect(0, 15, 64, 30, 0x01);
+  lcd.LCDListFillRect(10, 10, 20, 20, 0x01);
+
+  uint32_t start = dwt_cycles();
+  lcd.LCDupdateStrip();
+  uint32_t cycles = dwt_cycles() - start;
+
+  // 帧缓冲 + 图标行 对比 条带 + 显示列表 + 图标行
+  char buffer[96];
+  snprintf(buffer, sizeof(buffer), "strip: %lu cycles/frame, RAM %u bytes (full buffer %u bytes)\n",
+           cycles, (unsigned)(DISPLAY_WIDTH + sizeof(list) + DISPLAY_WIDTH), (unsigned)(FULLSCREEN + DISPLAY_WIDTH));
+  UART_Print(buffer);
+}
+
+/*!
+    @brief Print the drawPixel rate with and without the bit-band alias
+    @note Only draws into the buffer of mylcd, nothing is sent to the screen.
+ */
+void LCD_BenchmarkBitBand(void)
+{
+  const uint32_t pixels = 4096;
+  char buffer[80];
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    bool bitBand = (pass == 0);
+    mylcd.LCDBitBandSet(bitBand);
+    uint32_t start = dwt_cycles();
+    for (uint32_t i = 0; i < pixels; i++)
+    {
+      // 覆盖置位、清零和取反三种写法
+      mylcd.drawPixel(i & (DISPLAY_WIDTH - 1), (i >> 7) & (DISPLAY_HEIGHT - 1), i % 3);
+    }
+    uint32_t cycles = dwt_cycles() - start;
+    snprintf(buffer, sizeof(buffer), "drawPixel %s: %lu cycles, %lu pixels/s\n", bitBand ? "bit-band" : "byte RMW",
+             cycles, (uint32_t)(((uint64_t)pixels * SystemCoreClock) / cycles));
+    UART_Print(buffer);
+  }
+  mylcd.LCDBitBandSet(true);
+  mylcd.LCDclearBuffer();
+}
+
+/*!
+    @brief Print the fillRect time of the page-mask engine and of the per pixel path
+    @note Only draws into the buffer of mylcd, nothing is sent to the screen.
+ */
+void LCD_BenchmarkFill(void)
+{
+  static const char *modes[3] = {"BG", "FG", "INV"};
+  char buffer[96];
+  for (uint8_t colour = 0; colour < 3; colour++)
+  {
+    uint32_t start = dwt_cycles();
+    mylcd.fillRect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, colour);
+    mylcd.fillRect(10, 3, 40, 21, colour);
+    uint32_t native = dwt_cycles() - start;
+
+    // 限定作用域调用绕过虚函数，走原来的逐像素画线
+    start = dwt_cycles();
+    mylcd.ST7565_graphics::fillRect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, colour);
+    mylcd.ST7565_graphics::fillRect(10, 3, 40, 21, colour);
+    uint32_t pixels = dwt_cycles() - start;
+
+    snprintf(buffer, sizeof(buffer), "fillRect %s: %lu cycles page mask, %lu cycles per pixel\n", modes[colour], native, pixels);
+    UART_Print(buffer);
+  }
+  mylcd.LCDclearBuffer();
+}
+
+/*!
+    @brief Print the time of lines, circles and text through the virtual drawPixel and through ST7565_graphics_t
+    @note Both passes draw into the buffer of the same panel, nothing is sent to the screen.
+    The panel sits on its own recording bus so it never touches the controller behind mylcd.
+ */
+void LCD_BenchmarkCrtp(void)
+{
+  static ST7565_Bus_Recording bus;
+  static ST7565_Panel_128x64 panel(&bus);
+  ST7565_Parallel &base = panel; // 经基类引用调用，走虚函数 drawPixel
+  char text[] = "Hello World 123";
+  uint32_t cycles[2][3];
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    bool crtp = (pass == 1);
+    uint32_t start = dwt_cycles();
+    for (int16_t i = 0; i < DISPLAY_HEIGHT; i += 4)
+    {
+      if (crtp)
+        panel.drawLine(0, i, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1 - i, 2);
+      else
+        base.drawLine(0, i, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1 - i, 2);
+    }
+    cycles[pass][0] = dwt_cycles() - start;
+
+    start = dwt_cycles();
+    for (int16_t r = 4; r < DISPLAY_HEIGHT / 2; r += 4)
+    {
+      if (crtp)
+        panel.drawCircle(DISPLAY_WIDTH / 2, DISPLAY_HEIGHT / 2, r, 2);
+      else
+        base.drawCircle(DISPLAY_WIDTH / 2, DISPLAY_HEIGHT / 2, r, 2);
+    }
+    cycles[pass][1] = dwt_cycles() - start;
+
+    start = dwt_cycles();
+    for (uint8_t y = 0; y < DISPLAY_HEIGHT; y += 8)
+    {
+      if (crtp)
+        panel.drawText(0, y, text, 0x01, 0x00, 1);
+      else
+        base.drawText(0, y, text, 0x01, 0x00, 1);
+    }
+    cycles[pass][2] = dwt_cycles() - start;
+  }
+
+  static const char *names[3] = {"lines", "circles", "text"};
+  char buffer[80];
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    snprintf(buffer, sizeof(buffer), "%s: %lu cycles virtual, %lu cycles CRTP\n", names[i], cycles[0][i], cycles[1][i]);
+    UART_Print(buffer);
+  }
+}
+
+/*!
+    @brief Print the drawPixel and drawLine time for each of the four rotations
+    @note Only draws into the buffer of mylcd, nothing is sent to the screen.
+ */
+void LCD_BenchmarkRotation(void)
+{
+  const uint32_t pixels = 4096;
+  char buffer[80];
+  for (uint8_t rotation = LCD_Degrees_0; rotation <= LCD_Degrees_270; rotation++)
+  {
+    mylcd.setRotation((LCD_rotate_e)rotation);
+    int16_t w = mylcd.width();
+    int16_t h = mylcd.height();
+    uint32_t start = dwt_cycles();
+    for (uint32_t i = 0; i < pixels; i++)
+    {
+      mylcd.drawPixel(i % w, (i / w) % h, i % 3);
+    }
+    uint32_t pixelCycles = dwt_cycles() - start;
+
+    start = dwt_cycles();
+    for (int16_t i = 0; i < h; i += 4)
+    {
+      mylcd.drawLine(0, i, w - 1, h - 1 - i, 2);
+    }
+    uint32_t lineCycles = dwt_cycles() - start;
+
+    snprintf(buffer, sizeof(buffer), "rotation %u: drawPixel %lu cycles, lines %lu cycles\n", rotation * 90, pixelCycles, lineCycles);
+    UART_Print(buffer);
+  }
+  mylcd.setRotation(LCD_Degrees_0);
+  mylcd.LCDclearBuffer();
+}
+
+/*!
+    @brief Draw the portrait test picture used by LCD_BenchmarkTranspose
+ */
+static void LCD_BenchmarkPortraitPicture(void)
+{
+  char text[] = "Portrait";
+  int16_t w = mylcd.width();
+  int16_t h = mylcd.height();
+  for (int16_t i = 0; i < h; i += 8)
+  {
+    mylcd.drawLine(0, i, w - 1, h - 1 - i, 2);
+  }
+  mylcd.drawCircle(w / 2, h / 2, w / 2 - 1, 1);
+  for (uint8_t y = 0; y < h; y += 16)
+  {
+    mylcd.drawText(0, y, text, 0x01, 0x00, 1);
+  }
+}
+
+/*!
+    @brief Print the portrait drawing time with per pixel rotation and with
+    the transposed buffer, and the transpose cost of a full frame
+    @note Only draws into the buffer of mylcd, nothing is sent to the screen.
+ */
+void LCD_BenchmarkTranspose(void)
+{
+  static uint8_t portrait[FULLSCREEN];
+  char buffer[96];
+
+  mylcd.setRotation(LCD_Degrees_90);
+  uint32_t start = dwt_cycles();
+  LCD_BenchmarkPortraitPicture();
+  uint32_t perPixel = dwt_cycles() - start;
+
+  // LCDTransposeSet 把所有块标为已画，第一次转置即整帧
+  mylcd.LCDTransposeSet(portrait, LCD_Degrees_90);
+  start = dwt_cycles();
+  uint16_t frameBlocks = mylcd.LCDTransposeFlush();
+  uint32_t frameCycles = dwt_cycles() - start;
+
+  start = dwt_cycles();
+  LCD_BenchmarkPortraitPicture();
+  uint32_t drawCycles = dwt_cycles() - start;
+  start = dwt_cycles();
+  uint16_t blocks = mylcd.LCDTransposeFlush();
+  uint32_t flushCycles = dwt_cycles() - start;
+
+  snprintf(buffer, sizeof(buffer), "portrait per pixel: %lu cycles\n", perPixel);
+  UART_Print(buffer);
+  snprintf(buffer, sizeof(buffer), "portrait transposed: %lu cycles draw + %lu cycles for %u blocks\n", drawCycles, flushCycles, blocks);
+  UART_Print(buffer);
+  snprintf(buffer, sizeof(buffer), "transpose full frame: %lu cycles for %u blocks\n", frameCycles, frameBlocks);
+  UART_Print(buffer);
+
+  mylcd.LCDTransposeSet(nullptr, LCD_Degrees_90);
+  mylcd.setRotation(LCD_Degrees_0);
+  mylcd.LCDclearBuffer();
+}
+
+#endif // LCD_BENCHMARK
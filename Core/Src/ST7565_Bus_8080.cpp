@@ -0,0 +1,252 @@
+/*!
+    @file ST7565_Bus_8080.cpp
+    @brief 8080 parallel bus backends for the ST7565 driver, Source file.
+*/
+
+#include "ST7565_Bus_8080.h"
+
+/*!
+    @brief init the HAL GPIO bus object
+    @param cs GPIO Chip select
+    @param rst GPIO reset
+    @param dc GPIO data or command (A0)
+    @param wr GPIO write
+    @param rd GPIO read
+    @param dataPins array of 8 pins D0-D7, must outlive the object
+ */
+ST7565_Bus_Gpio::ST7565_Bus_Gpio(LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins)
+{
+    _LCD_CS = cs;
+    _LCD_RST = rst;
+    _LCD_DC = dc;
+    _LCD_WR = wr;
+    _LCD_RD = rd;
+    _dataPins = dataPins;
+    LCD_BusTimingToCycles(&LCD_BusTiming_ST7565P, &_busCycles);
+}
+
+/*!
+    @brief Configure the 13 bus pins as outputs and select the data writer
+    @return true
+ */
+bool ST7565_Bus_Gpio::begin(void)
+{
+    // 启用 GPIO 时钟
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_GPIOD_CLK_ENABLE();
+
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    LcdDataPin gpio_pins[13] = {
+        _LCD_CS,
+        _LCD_RST,
+        _LCD_DC,
+        _LCD_WR,
+        _LCD_RD,
+
+    };
+    // 将 _dataPins 数组的内容复制到 gpio_pins 数组中
+    for (size_t i = 0; i < 8; i++)
+    {
+        gpio_pins[i + 5] = _dataPins[i]; // 从第 6 个位置开始填充数据引脚
+    }
+
+    // 使用 gpio_pins 数组的大小进行循环
+    for (size_t i = 0; i < sizeof(gpio_pins) / sizeof(gpio_pins[0]); i++)
+    {
+        // 初始化 GPIO 引脚
+        GPIO_InitStruct.Pin = gpio_pins[i].pin;
+        GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        HAL_GPIO_Init(gpio_pins[i].port, &GPIO_InitStruct);
+    }
+
+    // 空闲电平：片选、写、读均为高
+    pinWrite(_LCD_CS, true);
+    pinWrite(_LCD_WR, true);
+    pinWrite(_LCD_RD, true);
+
+    // HAL 后端保留逐位写入，寄存器后端根据引脚映射选择字节写入方式
+    _dataBus.begin(_dataPins, !_registerAccess);
+    return true;
+}
+
+/*!
+    @brief Apply a write cycle timing profile
+    @param timing profile in ns
+ */
+void ST7565_Bus_Gpio::setTiming(const LCD_BusTiming_t &timing)
+{
+    LCD_BusTimingToCycles(&timing, &_busCycles);
+}
+
+/*!
+    @brief Drive the reset line
+    @param active true pulls RST low
+ */
+void ST7565_Bus_Gpio::reset(bool active)
+{
+    pinWrite(_LCD_RST, !active);
+}
+
+/*!
+    @brief Send command bytes with A0 low
+    @param commands command bytes
+    @param len number of bytes
+ */
+void ST7565_Bus_Gpio::sendCommands(const uint8_t *commands, uint16_t len)
+{
+    writeRun(false, commands, len, 1);
+}
+
+/*!
+    @brief Send display data bytes with A0 high
+    @param data data bytes
+    @param len number of bytes
+ */
+void ST7565_Bus_Gpio::sendData(const uint8_t *data, uint16_t len)
+{
+    writeRun(true, data, len, 1);
+}
+
+/*!
+    @brief Send the same display data byte len times
+    @param pattern data byte
+    @param len number of bytes
+ */
+void ST7565_Bus_Gpio::fillData(uint8_t pattern, uint16_t len)
+{
+    writeRun(true, &pattern, len, 0);
+}
+
+/*!
+    @brief Getter for the D0-D7 byte writer selected in begin
+    @return LCD_DataBus_Mode_e enum
+ */
+LCD_DataBus_Mode_e ST7565_Bus_Gpio::getDataBusMode(void) const
+{
+    return _dataBus.getMode();
+}
+
+/*!
+    @brief Clock a run of bytes out with A0 set and CS held low for the whole run
+    @param data true for display data (A0 high), false for commands
+    @param bytes pointer to the bytes to send
+    @param len number of bytes
+    @param step 1 walks through bytes, 0 repeats bytes[0] len times
+ */
+void ST7565_Bus_Gpio::writeRun(bool data, const uint8_t *bytes, uint16_t len, uint8_t step)
+{
+    // 设置命令/数据引脚（A0）
+    pinWrite(_LCD_DC, data);
+    LCD_BusWait(_busCycles.setup);
+
+    // 激活片选引脚（CS1），整段传输只拉低一次
+    pinWrite(_LCD_CS, false);
+    LCD_BusWait(_busCycles.setup);
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        // 置写使能引脚（WR）为低电平并设置数据引脚（D0-D7）
+        pinWrite(_LCD_WR, false);
+        _dataBus.write(*bytes);
+        bytes += step;
+        LCD_BusWait(_busCycles.low);
+
+        // WR 上升沿锁存数据
+        pinWrite(_LCD_WR, true);
+        LCD_BusWait(_busCycles.high);
+    }
+
+    // 取消片选（CS1）
+    LCD_BusWait(_busCycles.hold);
+    pinWrite(_LCD_CS, true);
+}
+
+/*!
+    @brief init the register 8080 bus object, same parameters as ST7565_Bus_Gpio
+ */
+ST7565_Bus_Reg8080::ST7565_Bus_Reg8080(LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins)
+    : ST7565_Bus_Gpio(cs, rst, dc, wr, rd, dataPins)
+{
+    _registerAccess = true;
+}
+
+/*!
+    @brief init the timer + DMA 8080 bus object
+    @param port the timer/DMA hardware, e.g. ST7565_DmaPort_Tim, or a host-side fake
+    @note Other parameters as ST7565_Bus_Gpio. The DMA channel IRQ handler
+    must call ST7565_Parallel::LCD_DMA_IRQHandler.
+ */
+ST7565_Bus_TimDma::ST7565_Bus_TimDma(LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins, ST7565_DmaPort *port)
+    : ST7565_Bus_Reg8080(cs, rst, dc, wr, rd, dataPins)
+{
+    _dmaPort = port;
+}
+
+/*!
+    @brief Configure the pins, then the timer and DMA channel
+    @return true, synchronous transfers work even if the DMA port refused the pin map
+ */
+bool ST7565_Bus_TimDma::begin(void)
+{
+    ST7565_Bus_Reg8080::begin();
+    _dmaReady = (_dmaPort != nullptr) && _dmaPort->begin(_dataBus, _LCD_WR, _busCycles);
+    return true;
+}
+
+/*!
+    @brief Apply a write cycle timing profile, the timer period follows
+    @param timing profile in ns
+ */
+void ST7565_Bus_TimDma::setTiming(const LCD_BusTiming_t &timing)
+{
+    ST7565_Bus_Reg8080::setTiming(timing);
+    if (_dmaReady)
+    {
+        _dmaReady = _dmaPort->begin(_dataBus, _LCD_WR, _busCycles);
+    }
+}
+
+/*!
+    @brief Whether the DMA port accepted the pin map
+    @return true if startDataAsync can be used
+ */
+bool ST7565_Bus_TimDma::canStartAsync(void)
+{
+    return _dmaReady;
+}
+
+/*!
+    @brief Set A0, assert CS and start the DMA burst
+    @param data data bytes, at most LCD_DMA_MAX_BURST
+    @param len number of bytes
+ */
+void ST7565_Bus_TimDma::startDataAsync(const uint8_t *data, uint16_t len)
+{
+    pinWrite(_LCD_DC, true);
+    LCD_BusWait(_busCycles.setup);
+    pinWrite(_LCD_CS, false);
+    LCD_BusWait(_busCycles.setup);
+    _dmaPort->start(data, len);
+}
+
+/*!
+    @brief Acknowledge the DMA transfer complete interrupt and release the bus
+    @return true if the burst has finished
+ */
+bool ST7565_Bus_TimDma::asyncComplete(void)
+{
+    if (!_dmaReady || !_dmaPort->complete())
+    {
+        return false;
+    }
+    // 先释放片选，再把 WR 交还给 GPIO，避免多锁存一个字节
+    LCD_BusWait(_busCycles.hold);
+    pinWrite(_LCD_CS, true);
+    _dmaPort->stop();
+    return true;
+}
@@ -0,0 +1,391 @@
+/*!
+    @file ST7565_Bus_Recording.cpp
+    @brief Host side ST7565 bus backend that records the traffic, Source file.
+*/
+
+#include "ST7565_Bus_Recording.h"
+#include <string.h>
+
+#define LCD_REC_CMD_VOLUME 0x81  /**< CMD_SET_VOLUME_FIRST, next byte is the contrast */
+#define LCD_REC_CMD_BOOSTER 0xF8 /**< CMD_SET_BOOSTER_FIRST, next byte is the ratio */
+
+/*!
+    @brief init the recording bus object
+    @param log optional array receiving every bus byte, may be nullptr
+    @param logSize number of entries in log, bytes past the end are counted but not logged
+ */
+ST7565_Bus_Recording::ST7565_Bus_Recording(LCD_BusRecord_t *log, uint32_t logSize)
+{
+    _log = log;
+    _logSize = (log == nullptr) ? 0 : logSize;
+    memset(_ram, 0, sizeof(_ram));
+}
+
+/*!
+    @brief Nothing to configure
+    @return true
+ */
+bool ST7565_Bus_Recording::begin(void)
+{
+    return true;
+}
+
+/*!
+    @brief Model the reset line, the address counters return to 0
+    @param active true holds the controller in reset
+ */
+void ST7565_Bus_Recording::reset(bool active)
+{
+    if (active)
+    {
+        _resets++;
+        _argCommand = 0;
+        _page = 0;
+        _column = 0;
+        _startLine = 0;
+        _displayOn = false;
+    }
+}
+
+/*!
+    @brief Record command bytes, one transaction
+    @param commands command bytes
+    @param len number of bytes
+ */
+void ST7565_Bus_Recording::sendCommands(const uint8_t *commands, uint16_t len)
+{
+    _transactions++;
+    for (uint16_t i = 0; i < len; i++)
+    {
+        record(0, commands[i]);
+        command(commands[i]);
+    }
+}
+
+/*!
+    @brief Record display data bytes, one transaction
+    @param bytes data bytes
+    @param len number of bytes
+ */
+void ST7565_Bus_Recording::sendData(const uint8_t *bytes, uint16_t len)
+{
+    _transactions++;
+    for (uint16_t i = 0; i < len; i++)
+    {
+        record(1, bytes[i]);
+        data(bytes[i]);
+    }
+}
+
+/*!
+    @brief Record the same display data byte len times, one transaction
+    @param pattern data byte
+    @param len number of bytes
+ */
+void ST7565_Bus_Recording::fillData(uint8_t pattern, uint16_t len)
+{
+    _transactions++;
+    for (uint16_t i = 0; i < len; i++)
+    {
+        record(1, pattern);
+        data(pattern);
+    }
+}
+
+/*!
+    @brief Offer a fake background transfer to LCDupdateAsync
+    @param enable true makes canStartAsync return true
+    @note The data is recorded at start, asyncComplete then reports the end
+    once, so a test calls LCD_DMA_IRQHandler to step the page state machine.
+ */
+void ST7565_Bus_Recording::setAsync(bool enable)
+{
+    _asyncEnabled = enable;
+}
+
+/*!
+    @brief Whether the fake background transfer is enabled
+    @return true after setAsync(true)
+ */
+bool ST7565_Bus_Recording::canStartAsync(void)
+{
+    return _asyncEnabled;
+}
+
+/*!
+    @brief Record a background data transfer and mark it pending
+    @param bytes data bytes
+    @param len number of bytes
+ */
+void ST7565_Bus_Recording::startDataAsync(const uint8_t *bytes, uint16_t len)
+{
+    sendData(bytes, len);
+    _asyncPending = true;
+}
+
+/*!
+    @brief Acknowledge the pending background transfer
+    @return true once per startDataAsync
+ */
+bool ST7565_Bus_Recording::asyncComplete(void)
+{
+    if (!_asyncPending)
+    {
+        return false;
+    }
+    _asyncPending = false;
+    return true;
+}
+
+/*!
+    @brief Forget the log and the counters, the controller model is kept
+ */
+void ST7565_Bus_Recording::clear(void)
+{
+    _logLength = 0;
+    _commandBytes = 0;
+    _dataBytes = 0;
+    _transactions = 0;
+    _resets = 0;
+}
+
+/*!
+    @brief Read back the modelled display RAM
+    @param page 0-8
+    @param column 0-131
+    @return the byte, 0 outside the RAM
+ */
+uint8_t ST7565_Bus_Recording::getRam(uint8_t page, uint8_t column) const
+{
+    if (page >= LCD_REC_PAGES || column >= LCD_REC_COLUMNS)
+    {
+        return 0;
+    }
+    return _ram[page][column];
+}
+
+/*!
+    @brief Count a byte and append it to the log if there is room
+    @param a0 0 command, 1 data
+    @param value the byte
+ */
+void ST7565_Bus_Recording::record(uint8_t a0, uint8_t value)
+{
+    if (a0)
+    {
+        _dataBytes++;
+    }
+    else
+    {
+        _commandBytes++;
+    }
+    if (_logLength < _logSize)
+    {
+        _log[_logLength].a0 = a0;
+        _log[_logLength].value = value;
+    }
+    _logLength++;
+}
+
+/*!
+    @brief Apply a command byte to the controller model
+    @param value the command byte
+ */
+void ST7565_Bus_Recording::command(uint8_t value)
+{
+    // 双字节命令的第二个字节
+    if (_argCommand == LCD_REC_CMD_VOLUME)
+    {
+        _contrast = value & 0x3F;
+        _argCommand = 0;
+        return;
+    }
+    if (_argCommand == LCD_REC_CMD_BOOSTER)
+    {
+        _argCommand = 0;
+        return;
+    }
+
+    if (value == LCD_REC_CMD_VOLUME || value == LCD_REC_CMD_BOOSTER)
+    {
+        _argCommand = value;
+    }
+    else if ((value & 0xF0) == 0xB0)
+    {
+        _page = value & 0x0F;
+    }
+    else if ((value & 0xF0) == 0x10)
+    {
+        _column = (_column & 0x0F) | ((value & 0x0F) << 4);
+    }
+    else if ((value & 0xF0) == 0x00)
+    {
+        _column = (_column & 0xF0) | (value & 0x0F);
+    }
+    else if ((value & 0xC0) == 0x40)
+    {
+        _startLine = value & 0x3F;
+    }
+    else if ((value & 0xFE) == 0xAE)
+    {
+        _displayOn = value & 0x01;
+    }
+}
+
+/*!
+    @brief Write a data byte into the model RAM, the column address auto increments
+    @param value the data byte
+ */
+void ST7565_Bus_Recording::data(uint8_t value)
+{
+    if (_page < LCD_REC_PAGES && _column < LCD_REC_COLUMNS)
+    {
+        _ram[_page][_column] = value;
+    }
+    if (_column < 0xFF)
+    {
+        _column++;
+    }
+}
+
+/*!
+    @brief init the SPI stand-in
+    @param sink recording bus receiving what the controller would see
+    @param pclkHz SPI kernel clock used for the prescaler model
+ */
+ST7565_SpiPort_Recording::ST7565_SpiPort_Recording(ST7565_Bus_Recording *sink, uint32_t pclkHz)
+{
+    _sink = sink;
+    _pclkHz = pclkHz;
+}
+
+/*!
+    @brief Pick the SCL the STM32 prescaler would give
+    @param maxHz fastest allowed SCL
+    @return false if no prescaler reaches maxHz
+ */
+bool ST7565_SpiPort_Recording::begin(uint32_t maxHz)
+{
+    if (maxHz > LCD_SPI_MAX_HZ)
+    {
+        maxHz = LCD_SPI_MAX_HZ;
+    }
+    uint32_t br = 0;
+    while ((_pclkHz >> (br + 1)) > maxHz)
+    {
+        if (++br > 7)
+        {
+            return false;
+        }
+    }
+    _clockHz = _pclkHz >> (br + 1);
+    return _sink->begin();
+}
+
+/*!
+    @brief Forward the reset line
+    @param active true holds the controller in reset
+ */
+void ST7565_SpiPort_Recording::reset(bool active)
+{
+    _sink->reset(active);
+}
+
+/*!
+    @brief Model CS1, changing it during a burst is an error
+    @param active true selects the controller
+ */
+void ST7565_SpiPort_Recording::select(bool active)
+{
+    if (_dmaPending)
+    {
+        _errors++;
+    }
+    _selected = active;
+}
+
+/*!
+    @brief Model A0, changing it during a burst is an error
+    @param data true for display data
+ */
+void ST7565_SpiPort_Recording::setA0(bool data)
+{
+    if (_dmaPending)
+    {
+        _errors++;
+    }
+    _a0 = data;
+}
+
+/*!
+    @brief Polled bytes
+    @param data bytes to send
+    @param len number of bytes
+    @param step 1 walks through data, 0 repeats data[0] len times
+ */
+void ST7565_SpiPort_Recording::write(const uint8_t *data, uint16_t len, uint8_t step)
+{
+    _polledBytes += len;
+    shift(data, len, step);
+}
+
+/*!
+    @brief DMA burst, recorded at once and reported by the next complete()
+    @param data bytes to send
+    @param len number of bytes
+    @param step 1 walks through data, 0 repeats data[0] len times
+    @param interrupt ignored, the test calls complete() or LCD_DMA_IRQHandler
+ */
+void ST7565_SpiPort_Recording::start(const uint8_t *data, uint16_t len, uint8_t step, bool interrupt)
+{
+    (void)interrupt;
+    if (_dmaPending)
+    {
+        _errors++;
+    }
+    _dmaBursts++;
+    shift(data, len, step);
+    _dmaPending = true;
+}
+
+/*!
+    @brief Acknowledge the recorded burst
+    @return true once per start
+ */
+bool ST7565_SpiPort_Recording::complete(void)
+{
+    if (!_dmaPending)
+    {
+        return false;
+    }
+    _dmaPending = false;
+    return true;
+}
+
+/*!
+    @brief Hand the bytes to the sink as one transaction with the current A0
+    @param data bytes to send
+    @param len number of bytes
+    @param step 1 walks through data, 0 repeats data[0] len times
+ */
+void ST7565_SpiPort_Recording::shift(const uint8_t *data, uint16_t len, uint8_t step)
+{
+    if (!_selected)
+    {
+        // 片选无效时控制器忽略 SCL
+        _errors += len;
+        return;
+    }
+    if (!_a0)
+    {
+        _sink->sendCommands(data, len);
+    }
+    else if (step)
+    {
+        _sink->sendData(data, len);
+    }
+    else
+    {
+        _sink->fillData(*data, len);
+    }
+}
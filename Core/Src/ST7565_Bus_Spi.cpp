@@ -0,0 +1,152 @@
+/*!
+    @file ST7565_Bus_Spi.cpp
+    @brief 4-wire serial (SPI) bus backend for the ST7565 driver, Source file.
+*/
+
+#include "ST7565_Bus_Spi.h"
+
+/*!
+    @brief init the SPI bus object
+    @param port the SPI hardware, e.g. ST7565_SpiPort_Hw, or a host-side stand-in
+    @param maxHz fastest allowed SCL, capped at LCD_SPI_MAX_HZ
+    @note The DMA channel IRQ handler must call ST7565_Parallel::LCD_DMA_IRQHandler.
+ */
+ST7565_Bus_Spi::ST7565_Bus_Spi(ST7565_SpiPort *port, uint32_t maxHz)
+{
+    _port = port;
+    _maxHz = maxHz;
+}
+
+/*!
+    @brief Configure the pins, the SPI and the DMA channel
+    @return false if the port cannot be configured
+ */
+bool ST7565_Bus_Spi::begin(void)
+{
+    _ready = (_port != nullptr) && _port->begin(_maxHz);
+    return _ready;
+}
+
+/*!
+    @brief Change the SCL limit, takes effect at once if the bus is running
+    @param maxHz fastest allowed SCL, capped at LCD_SPI_MAX_HZ
+ */
+void ST7565_Bus_Spi::setMaxClock(uint32_t maxHz)
+{
+    _maxHz = maxHz;
+    if (_ready)
+    {
+        begin();
+    }
+}
+
+/*!
+    @brief Getter for the SCL frequency in use
+    @return Hz, 0 before begin
+ */
+uint32_t ST7565_Bus_Spi::getClockHz(void)
+{
+    return _ready ? _port->getClockHz() : 0;
+}
+
+/*!
+    @brief Drive the reset line
+    @param active true holds the controller in reset
+ */
+void ST7565_Bus_Spi::reset(bool active)
+{
+    _port->reset(active);
+}
+
+/*!
+    @brief Send command bytes with A0 low
+    @param commands command bytes
+    @param len number of bytes
+ */
+void ST7565_Bus_Spi::sendCommands(const uint8_t *commands, uint16_t len)
+{
+    writeRun(false, commands, len, 1);
+}
+
+/*!
+    @brief Send display data bytes with A0 high
+    @param data data bytes
+    @param len number of bytes
+ */
+void ST7565_Bus_Spi::sendData(const uint8_t *data, uint16_t len)
+{
+    writeRun(true, data, len, 1);
+}
+
+/*!
+    @brief Send the same display data byte len times
+    @param pattern data byte
+    @param len number of bytes
+ */
+void ST7565_Bus_Spi::fillData(uint8_t pattern, uint16_t len)
+{
+    writeRun(true, &pattern, len, 0);
+}
+
+/*!
+    @brief Whether the port is configured for DMA page bursts
+    @return true after a successful begin
+ */
+bool ST7565_Bus_Spi::canStartAsync(void)
+{
+    return _ready;
+}
+
+/*!
+    @brief Set A0, assert CS and start the DMA burst of one page
+    @param data data bytes
+    @param len number of bytes
+ */
+void ST7565_Bus_Spi::startDataAsync(const uint8_t *data, uint16_t len)
+{
+    _port->setA0(true);
+    _port->select(true);
+    _asyncActive = true;
+    _port->start(data, len, 1, true);
+}
+
+/*!
+    @brief Acknowledge the DMA transfer complete interrupt and release CS
+    @return true if the burst has finished
+ */
+bool ST7565_Bus_Spi::asyncComplete(void)
+{
+    if (!_asyncActive || !_port->complete())
+    {
+        return false;
+    }
+    _asyncActive = false;
+    _port->select(false);
+    return true;
+}
+
+/*!
+    @brief One transaction: A0, CS low, bytes, CS high
+    @param data true for display data (A0 high), false for commands
+    @param bytes pointer to the bytes to send
+    @param len number of bytes
+    @param step 1 walks through bytes, 0 repeats bytes[0] len times
+ */
+void ST7565_Bus_Spi::writeRun(bool data, const uint8_t *bytes, uint16_t len, uint8_t step)
+{
+    _port->setA0(data);
+    _port->select(true);
+    if (len >= LCD_SPI_DMA_MIN_BURST)
+    {
+        // 长数据段用 DMA 发送，查询等待完成（不开中断）
+        _port->start(bytes, len, step, false);
+        while (!_port->complete())
+        {
+        }
+    }
+    else
+    {
+        _port->write(bytes, len, step);
+    }
+    _port->select(false);
+}
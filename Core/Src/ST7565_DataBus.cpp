@@ -0,0 +1,154 @@
+/*!
+    @file ST7565_DataBus.cpp
+    @brief 8080 parallel data bus byte writer, Source file.
+*/
+
+#include "ST7565_DataBus.h"
+
+ST7565_DataBus::~ST7565_DataBus()
+{
+    delete[] _lut;
+}
+
+/*!
+    @brief Analyse the pin map and select the byte writer
+    @param dataPins array of 8 pins, D0 first
+    @param forceGeneric true keeps the HAL_GPIO_WritePin loop whatever the pin map
+    @note Call after the GPIOs are configured, the array must outlive this object.
+ */
+void ST7565_DataBus::begin(const LcdDataPin *dataPins, bool forceGeneric)
+{
+    _dataPins = dataPins;
+    _mode = LCD_DataBus_Generic;
+    _numPorts = 0;
+    delete[] _lut;
+    _lut = nullptr;
+
+    if (forceGeneric)
+    {
+        return;
+    }
+
+    // 每个数据引脚必须是单一引脚位
+    for (uint8_t i = 0; i < LCD_DATA_BUS_WIDTH; i++)
+    {
+        uint16_t pin = dataPins[i].pin;
+        if (pin == 0 || (pin & (pin - 1)) != 0)
+        {
+            return;
+        }
+    }
+
+    // 同一端口且 D0-D7 连续递增：移位后一次写 BSRR
+    bool contiguous = true;
+    for (uint8_t i = 1; i < LCD_DATA_BUS_WIDTH; i++)
+    {
+        if (dataPins[i].port != dataPins[0].port || dataPins[i].pin != (uint16_t)(dataPins[0].pin << i))
+        {
+            contiguous = false;
+            break;
+        }
+    }
+    if (contiguous)
+    {
+        _port = dataPins[0].port;
+        _shift = 0;
+        while ((dataPins[0].pin >> _shift) != 1)
+        {
+            _shift++;
+        }
+        _mask = (uint16_t)(0xFF << _shift);
+        _numPorts = 1;
+        _mode = LCD_DataBus_SinglePort;
+        return;
+    }
+
+    // 引脚分散：统计使用的端口
+    GPIO_TypeDef *ports[LCD_DATA_BUS_WIDTH];
+    for (uint8_t i = 0; i < LCD_DATA_BUS_WIDTH; i++)
+    {
+        uint8_t p = 0;
+        while (p < _numPorts && ports[p] != dataPins[i].port)
+        {
+            p++;
+        }
+        if (p == _numPorts)
+        {
+            if (_numPorts == LCD_DATA_BUS_MAX_PORTS)
+            {
+                _numPorts = 0;
+                return;
+            }
+            ports[_numPorts++] = dataPins[i].port;
+        }
+    }
+
+    // 为每个端口预计算低/高半字节的置位表
+    _lut = new PortLUT[_numPorts];
+    for (uint8_t p = 0; p < _numPorts; p++)
+    {
+        PortLUT &lut = _lut[p];
+        lut.port = ports[p];
+        lut.mask = 0;
+        for (uint8_t n = 0; n < 16; n++)
+        {
+            lut.low[n] = 0;
+            lut.high[n] = 0;
+        }
+        for (uint8_t i = 0; i < LCD_DATA_BUS_WIDTH; i++)
+        {
+            if (dataPins[i].port != lut.port)
+            {
+                continue;
+            }
+            lut.mask |= dataPins[i].pin;
+            for (uint8_t n = 0; n < 16; n++)
+            {
+                if (i < 4 && (n & (1 << i)))
+                {
+                    lut.low[n] |= dataPins[i].pin;
+                }
+                if (i >= 4 && (n & (1 << (i - 4))))
+                {
+                    lut.high[n] |= dataPins[i].pin;
+                }
+            }
+        }
+    }
+    _mode = LCD_DataBus_PortLUT;
+}
+
+/*!
+    @brief Getter for the selected byte writer
+    @return LCD_DataBus_Mode_e enum
+ */
+LCD_DataBus_Mode_e ST7565_DataBus::getMode(void) const
+{
+    return _mode;
+}
+
+/*!
+    @brief Getter for the number of GPIO ports the data lines use
+    @return 1 for SinglePort, 1-4 for PortLUT, 0 for Generic
+ */
+uint8_t ST7565_DataBus::getPortCount(void) const
+{
+    return _numPorts;
+}
+
+/*!
+    @brief Getter for the data port when all data lines share one port
+    @return the GPIO port, nullptr if the lines use several ports or the generic loop
+ */
+GPIO_TypeDef *ST7565_DataBus::getPort(void) const
+{
+    if (_mode == LCD_DataBus_SinglePort)
+    {
+        return _port;
+    }
+    if (_mode == LCD_DataBus_PortLUT && _numPorts == 1)
+    {
+        return _lut[0].port;
+    }
+    return nullptr;
+}
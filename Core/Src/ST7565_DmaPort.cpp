@@ -0,0 +1,180 @@
+/*!
+    @file ST7565_DmaPort.cpp
+    @brief Timer paced DMA transfers into the data port, Source file.
+    @note The timer is assumed to run at SystemCoreClock (TIM1 on APB2 with
+    prescaler 1), so the bus timing in CPU cycles is used for its period.
+*/
+
+#include "ST7565_DmaPort.h"
+
+#define LCD_GPIO_OUTPUT_PP 0x3U /**< CRL/CRH: general purpose push-pull, 50 MHz */
+#define LCD_GPIO_AF_PP 0xBU     /**< CRL/CRH: alternate function push-pull, 50 MHz */
+
+#define LCD_TIM_OCMODE_FORCED_INACTIVE 0x4U
+#define LCD_TIM_OCMODE_PWM2 0x7U
+
+/*!
+    @brief Set the output compare mode of a timer channel
+    @param tim the timer
+    @param channel 1-4
+    @param mode OCxM value
+ */
+static void LCD_TimOCMode(TIM_TypeDef *tim, uint8_t channel, uint32_t mode)
+{
+    volatile uint32_t *ccmr = (channel <= 2) ? &tim->CCMR1 : &tim->CCMR2;
+    uint32_t shift = ((channel - 1) & 1) * 8 + 4;
+    *ccmr = (*ccmr & ~(0x7U << shift)) | (mode << shift);
+}
+
+/*!
+    @brief init the timer/DMA port object
+    @param config timer and DMA channel wiring
+ */
+ST7565_DmaPort_Tim::ST7565_DmaPort_Tim(const LCD_DmaConfig_t &config)
+{
+    _config = config;
+}
+
+ST7565_DmaPort_Tim::~ST7565_DmaPort_Tim()
+{
+    delete[] _words;
+}
+
+/*!
+    @brief Configure the timer, the DMA channel and its interrupt
+    @param bus data bus, all lines must be on one port
+    @param wr the WR pin, must be the configured timer output
+    @param cycles bus timing in CPU cycles
+    @return false if the pin map or the timer cannot be used
+ */
+bool ST7565_DmaPort_Tim::begin(const ST7565_DataBus &bus, const LcdDataPin &wr, const LCD_BusCycles_t &cycles)
+{
+    _dataPort = bus.getPort();
+    if (_dataPort == nullptr || !IS_TIM_REPETITION_COUNTER_INSTANCE(_config.timer))
+    {
+        return false;
+    }
+    _bus = &bus;
+    _wr = wr;
+    _dmaIndex = (uint8_t)(((uintptr_t)_config.dma - (uintptr_t)DMA1_Channel1) / ((uintptr_t)DMA1_Channel2 - (uintptr_t)DMA1_Channel1));
+    if (_words == nullptr)
+    {
+        _words = new uint32_t[LCD_DMA_MAX_BURST];
+    }
+
+    __HAL_RCC_TIM1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_AFIO_CLK_ENABLE();
+    AFIO_REMAP_PARTIAL(_config.remap, _config.remapMask);
+
+    // WR 在 CNT < CCR 期间为低，CCR 处上升沿锁存数据
+    uint32_t rise = ((cycles.low > LCD_DMA_LATENCY_CYCLES) ? cycles.low : LCD_DMA_LATENCY_CYCLES) + 1;
+    uint32_t period = rise + cycles.high;
+    if (period < LCD_DMA_MIN_PERIOD_CYCLES)
+    {
+        period = LCD_DMA_MIN_PERIOD_CYCLES;
+    }
+
+    TIM_TypeDef *tim = _config.timer;
+    tim->CR1 = TIM_CR1_OPM;
+    tim->CR2 = 0;
+    tim->PSC = 0;
+    tim->ARR = period - 1;
+    tim->CCER = 0;
+    tim->CCMR1 = 0;
+    tim->CCMR2 = 0;
+
+    // 先强制无效电平，保证空闲时 WR 输出为低
+    LCD_TimOCMode(tim, _config.wrChannel, LCD_TIM_OCMODE_FORCED_INACTIVE);
+    LCD_TimOCMode(tim, _config.wrChannel, LCD_TIM_OCMODE_PWM2);
+    (&tim->CCR1)[_config.wrChannel - 1] = rise;
+    (&tim->CCR1)[_config.dmaChannel - 1] = 1;
+
+    uint32_t ccerShift = (_config.wrChannel - 1) * 4;
+    tim->CCER = (_config.wrComplementary ? TIM_CCER_CC1NE : TIM_CCER_CC1E) << ccerShift;
+    tim->DIER = TIM_DIER_CC1DE << (_config.dmaChannel - 1);
+    tim->BDTR = TIM_BDTR_MOE;
+
+    _config.dma->CCR = 0;
+    _config.dma->CPAR = (uint32_t)(uintptr_t)&_dataPort->BSRR;
+
+    HAL_NVIC_SetPriority(_config.dmaIRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(_config.dmaIRQn);
+    return true;
+}
+
+/*!
+    @brief Expand the burst to BSRR words, arm the DMA and start the timer
+    @param data bytes to send
+    @param len number of bytes, 1 to LCD_DMA_MAX_BURST
+ */
+void ST7565_DmaPort_Tim::start(const uint8_t *data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        _words[i] = _bus->bsrrWord(data[i]);
+    }
+
+    DMA_Channel_TypeDef *dma = _config.dma;
+    dma->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF1 << (4 * _dmaIndex);
+    dma->CMAR = (uint32_t)(uintptr_t)_words;
+    dma->CNDTR = len;
+    dma->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_1 | DMA_CCR_PL_1 | DMA_CCR_TCIE | DMA_CCR_EN;
+
+    // 单脉冲模式 + 重复计数器：恰好产生 len 个 WR 脉冲后自动停止
+    TIM_TypeDef *tim = _config.timer;
+    tim->RCR = len - 1;
+    tim->EGR = TIM_EGR_UG;
+    tim->SR = 0;
+
+    pinMode(LCD_GPIO_AF_PP);
+    tim->CR1 |= TIM_CR1_CEN;
+}
+
+/*!
+    @brief Acknowledge the DMA transfer complete flag
+    @return true when the burst is finished
+    @note Waits for the timer to stop, at most one WR cycle, so the last
+    byte is latched before the caller releases CS.
+ */
+bool ST7565_DmaPort_Tim::complete(void)
+{
+    uint32_t tcif = DMA_ISR_TCIF1 << (4 * _dmaIndex);
+    if ((DMA1->ISR & tcif) == 0)
+    {
+        return false;
+    }
+    DMA1->IFCR = DMA_IFCR_CGIF1 << (4 * _dmaIndex);
+    _config.dma->CCR = 0;
+
+    while (_config.timer->CR1 & TIM_CR1_CEN)
+    {
+    }
+    return true;
+}
+
+/*!
+    @brief Drive WR high as a GPIO again
+ */
+void ST7565_DmaPort_Tim::stop(void)
+{
+    _wr.port->BSRR = _wr.pin;
+    pinMode(LCD_GPIO_OUTPUT_PP);
+}
+
+/*!
+    @brief Switch the WR pin between GPIO output and timer output
+    @param cnfMode CNF/MODE nibble for CRL/CRH
+ */
+void ST7565_DmaPort_Tim::pinMode(uint32_t cnfMode)
+{
+    uint8_t pos = 0;
+    while ((_wr.pin >> pos) != 1)
+    {
+        pos++;
+    }
+    volatile uint32_t *cr = (pos < 8) ? &_wr.port->CRL : &_wr.port->CRH;
+    uint32_t shift = (pos & 7) * 4;
+    *cr = (*cr & ~(0xFU << shift)) | (cnfMode << shift);
+}
@@ -24,7 +24,7 @@ ST7565_Parallel_Screen::ST7565_Parallel_Screen(uint8_t *mybuffer, uint8_t w, uin
 }
 
 /*!
-    @brief init the LCD class object
+    @brief init the LCD class object on the 8080 parallel register bus
     @param width width of LCD in pixels
     @param height height of LCD in pixels
     @param cs GPIO Chip select
@@ -32,20 +32,67 @@ ST7565_Parallel_Screen::ST7565_Parallel_Screen(uint8_t *mybuffer, uint8_t w, uin
     @param dc GPIO data or command
     @param wr GPIO write
     @param rd GPIO read
+    @param dataPins array of 8 pins D0-D7
  */
-ST7565_Parallel::ST7565_Parallel(int16_t width, int16_t height, LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins) : ST7565_graphics(width, height)
+ST7565_Parallel::ST7565_Parallel(int16_t width, int16_t height, LcdDataPin cs, LcdDataPin rst, LcdDataPin dc, LcdDataPin wr, LcdDataPin rd, LcdDataPin *dataPins)
+    : ST7565_Parallel(width, height, new ST7565_Bus_Reg8080(cs, rst, dc, wr, rd, dataPins))
 {
-    // Initialize other members if necessary
-    _LCD_CS = cs;
-    _LCD_RST = rst;
-    _LCD_DC = dc;
-    _LCD_WR = wr;
-    _LCD_RD = rd;
-    _dataPins = dataPins;
+    _ownsBus = true;
+}
+
+/*!
+    @brief init the LCD class object on any bus backend
+    @param width width of LCD in pixels
+    @param height height of LCD in pixels
+    @param bus the transport, e.g. ST7565_Bus_Reg8080 or ST7565_Bus_Recording,
+    must outlive the object
+ */
+ST7565_Parallel::ST7565_Parallel(int16_t width, int16_t height, ST7565_Bus *bus)
+    : ST7565_Parallel(width, height, bus, new uint8_t[_iconwidthScreen])
+{
+    _ownsIconBuffer = true;
+}
 
+/*!
+    @brief init the LCD class object with a caller supplied icon row buffer
+    @param width width of LCD in pixels
+    @param height height of LCD in pixels
+    @param bus the transport, must outlive the object
+    @param iconBuffer _iconwidthScreen bytes for the icon row, nullptr for a
+    panel without icons, the icon functions then do nothing
+    @note Used by ST7565_Panel so that no buffer comes from the heap.
+ */
+ST7565_Parallel::ST7565_Parallel(int16_t width, int16_t height, ST7565_Bus *bus, uint8_t *iconBuffer) : ST7565_graphics(width, height)
+{
+    _bus = bus;
     _widthScreen = width;
     _heightScreen = height;
-    _InactiveBuffer = new uint8_t[_bufferSize];
+    _bufferSize = _widthScreen * (_heightScreen / 8);
+    // 图标行只用 128 字节
+    _InactiveBuffer = iconBuffer;
+    if (_InactiveBuffer != nullptr)
+    {
+        memset(_InactiveBuffer, 0x00, _iconwidthScreen);
+    }
+    _pixelWriter = &ST7565_Parallel::LCD_PixelRotated<LCD_Degrees_0>;
+    LCDinvalidateAll();
+}
+
+/*!
+    @brief Frees the bus and the buffers the constructors and LCDDiffModeSet took from the heap
+ */
+ST7565_Parallel::~ST7565_Parallel()
+{
+    if (_ownsBus)
+    {
+        delete _bus;
+    }
+    if (_ownsIconBuffer)
+    {
+        delete[] _InactiveBuffer;
+    }
+    delete[] _diffShadow;
+    delete[] _diffHash;
 }
 
 /*!
@@ -55,38 +102,12 @@ ST7565_Parallel::ST7565_Parallel(int16_t width, int16_t height, LcdDataPin cs, L
  */
 void ST7565_Parallel::LCDbegin(uint8_t _VbiasPot, uint8_t _AddressSet)
 {
-    // 启用 GPIO 时钟
-    __HAL_RCC_GPIOA_CLK_ENABLE();
-    __HAL_RCC_GPIOB_CLK_ENABLE();
-    __HAL_RCC_GPIOC_CLK_ENABLE();
-    __HAL_RCC_GPIOD_CLK_ENABLE();
-
-    GPIO_InitTypeDef GPIO_InitStruct = {0};
-
-    LcdDataPin gpio_pins[13] = {
-        _LCD_CS,
-        _LCD_RST,
-        _LCD_DC,
-        _LCD_WR,
-        _LCD_RD,
-
-    };
-    // 将 _dataPins 数组的内容复制到 gpio_pins 数组中
-    for (size_t i = 0; i < 8; i++)
-    {
-        gpio_pins[i + 5] = _dataPins[i]; // 从第 6 个位置开始填充数据引脚
-    }
+    // 总线时序等待使用 DWT 周期计数器
+    delay_us_init();
 
-    // 使用 gpio_pins 数组的大小进行循环
-    for (size_t i = 0; i < sizeof(gpio_pins) / sizeof(gpio_pins[0]); i++)
-    {
-        // 初始化 GPIO 引脚
-        GPIO_InitStruct.Pin = gpio_pins[i].pin;
-        GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
-        GPIO_InitStruct.Pull = GPIO_NOPULL;
-        HAL_GPIO_Init(gpio_pins[i].port, &GPIO_InitStruct);
-    }
+    // 时钟配置完成后按 SystemCoreClock 重新计算总线时序，再初始化引脚和外设
+    _bus->setTiming(_busTiming);
+    _bus->begin();
 
     // _VbiasPOT = VbiasPOT;
 
@@ -97,108 +118,231 @@ void ST7565_Parallel::LCDbegin(uint8_t _VbiasPot, uint8_t _AddressSet)
 
     // _AddressCtrl = AddressSet;
 
+    _initStartTick = HAL_GetTick();
     LCDinit();
 }
 
 /*!
-    @brief Called from LCDbegin carries out Power on sequence and register init
-    Can be used to reset LCD to default values.
+    @brief Start the power-on sequence without blocking, LCDinitTick walks it
+    @return LCD_BusBusy if a sequence is already running, LCD_Success otherwise
+    @note Needs SysTick running (HAL_Init). Set ActiveBuffer first, it is the
+    first frame. Until LCDinitTick has sent the last command the update
+    functions leave the bus alone (LCD_BusBusy where they return a code);
+    after that LCDinitDone or the first update sends the frame.
  */
-void ST7565_Parallel::LCDinit()
+LCD_Return_Codes_e ST7565_Parallel::LCDbeginAsync(void)
 {
-    LCD_CS_HIGH();
-    HAL_Delay(UC1609_INIT_DELAY2);
-
-    LCDReset();
-
-    LCD_WR_LOW();
-    LCD_RD_HIGH();
+    if (_initState == InitRunning)
+    {
+        return LCD_BusBusy;
+    }
+    // 总线时序等待使用 DWT 周期计数器
     delay_us_init();
-    // 初始化LCD，发送一系列命令
-    ST7565_send_command(CMD_SET_BIAS_9);          // 设置偏置比为1/9
-    ST7565_send_command(CMD_SET_COM_NORMAL);      // 设置ADC为正常
-    ST7565_send_command(CMD_SET_COM_REVERSE);     // 设置COM输出方向
-    ST7565_send_command(CMD_SET_DISP_START_LINE); // 设置显示起始行
-
-    ST7565_send_command(CMD_SET_BOOSTER_FIRST | CMD_SET_BOOSTER_234);
+    _bus->setTiming(_busTiming);
+    _bus->begin();
 
-    ST7565_send_command(CMD_SET_POWER_CONTROL | 0x4);
-    HAL_Delay(5);
-    ST7565_send_command(CMD_SET_POWER_CONTROL | 0x6);
-    HAL_Delay(5);
-    ST7565_send_command(CMD_SET_POWER_CONTROL | 0x7);
-    HAL_Delay(5);
-    ST7565_send_command(CMD_SET_RESISTOR_RATIO | 0x4);
+    _initStartTick = HAL_GetTick();
+    _initStep = 0;
+    _initWaitMs = 0;
+    _initState = InitRunning;
+    return LCD_Success;
+}
 
-    HAL_Delay(5);
+/*!
+    @brief Advance the power-on sequence started by LCDbeginAsync
+    @note Call every 1 ms, e.g. from HAL_SYSTICK_Callback. Steps without a
+    delay run back to back. Only command bytes go out from the tick, the
+    first frame is left to LCDinitDone or the first LCDupdate/LCDupdateAsync.
+ */
+void ST7565_Parallel::LCDinitTick(void)
+{
+    if (_initState != InitRunning)
+    {
+        return;
+    }
+    if (_initWaitMs > 0 && --_initWaitMs > 0)
+    {
+        return;
+    }
 
-    // 设置对比度
-    LCD_Contrast(_VbiasPOT); // 设置对比度值
+    uint16_t wait = 0;
+    while (wait == 0)
+    {
+        if (!LCD_InitStepRun(&wait))
+        {
+            // 整帧较慢，不在中断里发送
+            LCD_InitFinish();
+            _initState = InitFramePending;
+            return;
+        }
+    }
+    _initWaitMs = wait;
+}
 
-    // 开启显示
-    ST7565_send_command(CMD_DISPLAY_ON);
-    LCD_Mode(0);
+/*!
+    @brief Check whether the power-on sequence has finished
+    @return true once the first frame is out
+    @note Sends the first frame once LCDinitTick has sent the last command,
+    call it from the main loop, not from an interrupt.
+ */
+bool ST7565_Parallel::LCDinitDone(void)
+{
+    if (_initState == InitFramePending)
+    {
+        LCD_InitFirstFrame();
+    }
+    return _initState == InitDone;
+}
 
-    // 清空显示缓冲区
-    // memset(ST7565_Buffer, 0, sizeof(ST7565_Buffer));
-    // memset(ST7565_Buffer_logo, 0, sizeof(ST7565_Buffer_logo));
+/*!
+    @brief Getter for the time-to-first-frame
+    @return ms from LCDbegin/LCDbeginAsync until the first frame was out
+ */
+uint32_t ST7565_Parallel::LCDFirstFrameTimeGet(void)
+{
+    return _firstFrameMs;
+}
 
-    // 更新屏幕显示
-    // LCD_UpdateScreen();
-    LCDupdate();
+/*!
+    @brief Select the power-on sequence of a controller variant
+    @param controller LCD_Controller_e enum
+ */
+void ST7565_Parallel::LCDInitTableSet(LCD_Controller_e controller)
+{
+    _initTable = LCD_InitTableGet(controller);
+}
 
-    // // 重置当前光标位置
-    // ST7565.CurrentX = 0;
-    // ST7565.CurrentY = 0;
+/*!
+    @brief Set a custom power-on sequence
+    @param table steps ending with LCD_InitOp_End, must outlive the object
+ */
+void ST7565_Parallel::LCDInitTableSet(const LCD_InitStep_t *table)
+{
+    _initTable = table;
+}
 
-    // // 标记初始化完成
-    // ST7565.Initialized = 1;
+/*!
+    @brief Called from LCDbegin carries out Power on sequence and register init
+    Can be used to reset LCD to default values.
+    @note Blocks for the table delays, see LCDbeginAsync for the non-blocking version.
+ */
+void ST7565_Parallel::LCDinit()
+{
+    uint16_t wait;
+    // 同步执行时 LCDinitTick 不参与
+    _initStep = 0;
+    _initState = InitIdle;
+    while (LCD_InitStepRun(&wait))
+    {
+        if (wait > 0)
+        {
+            HAL_Delay(wait);
+        }
+    }
+    LCD_InitFinish();
+    LCD_InitFirstFrame();
+}
 
-    // LCD_CS_HIGH();
+/*!
+    @brief Run the next power-on table step
+    @param delayMs receives the wait required after the step
+    @return false at the end of the table
+ */
+bool ST7565_Parallel::LCD_InitStepRun(uint16_t *delayMs)
+{
+    const LCD_InitStep_t &step = _initTable[_initStep];
+    *delayMs = step.delayMs;
+    switch (step.op)
+    {
+    case LCD_InitOp_Command:
+        if ((step.value & 0xF8) == CMD_SET_POWER_CONTROL)
+        {
+            LCD_CommandShadowed(step.value, &_shadow.power);
+        }
+        else if ((step.value & 0xC0) == CMD_SET_DISP_START_LINE)
+        {
+            LCD_CommandShadowed(step.value, &_shadow.startLine);
+        }
+        else
+        {
+            ST7565_send_command(step.value);
+        }
+        break;
+    case LCD_InitOp_ResetActive:
+        _bus->reset(true);
+        LCDShadowInvalidate();
+        LCDinvalidateAll();
+        break;
+    case LCD_InitOp_ResetRelease:
+        _bus->reset(false);
+        break;
+    default:
+        return false;
+    }
+    _initStep++;
+    return true;
 }
 
 /*!
-    @brief Send data byte to the LCD
-    @param byte the data byte to send
+    @brief Contrast, display on and start line, the last commands of the power-on sequence
  */
-void ST7565_Parallel::ST7565_write(uint8_t byte)
+void ST7565_Parallel::LCD_InitFinish(void)
 {
-    // 激活片选引脚（CS1）
-    LCD_CS_LOW();
-    delay_us(UC1609_RESET_DELAY);
+    // 设置对比度
+    LCD_Contrast(_VbiasPOT); // 设置对比度值
 
-    // 置写使能引脚（WR）为低电平
-    LCD_WR_LOW();
-    delay_us(UC1609_RESET_DELAY);
+    // 开启显示
+    LCD_CommandShadowed(CMD_DISPLAY_ON, &_shadow.display);
+    LCD_Mode(0);
+    // 缓冲区按当前滚动位置排列，恢复起始行
+    LCD_CommandShadowed(CMD_SET_DISP_START_LINE | _scrollLine, &_shadow.startLine);
+}
 
-    // 设置数据引脚（D0-D7）
-    for (uint8_t i = 0; i < 8; i++)
+/*!
+    @brief Send the first frame and end the power-on sequence
+ */
+void ST7565_Parallel::LCD_InitFirstFrame(void)
+{
+    // 先置完成，下面的 LCDupdate 不再转回这里
+    _initState = InitDone;
+    // 更新屏幕显示，未设置 ActiveBuffer 时清屏
+    if (this->ActiveBuffer != nullptr)
     {
-        HAL_GPIO_WritePin(_dataPins[i].port, _dataPins[i].pin, (byte >> i) & 0x01 ? GPIO_PIN_SET : GPIO_PIN_RESET);
+        LCDupdate();
     }
-    delay_us(UC1609_RESET_DELAY);
-
-    // 置写使能引脚（WR）为高电平
-    LCD_WR_HIGH();
-    delay_us(UC1609_RESET_DELAY);
+    else
+    {
+        LCDFillScreen(0x00);
+    }
+    _firstFrameMs = HAL_GetTick() - _initStartTick;
+}
 
-    // 取消片选（CS1）
-    LCD_CS_HIGH();
-    delay_us(UC1609_RESET_DELAY);
+/*!
+    @brief Check an update may use the bus, the power-on sequence of
+    LCDbeginAsync owns it until the last command is out
+    @return false while LCDinitTick is still sending, true otherwise
+    @note Sends the first frame first if it is pending.
+ */
+bool ST7565_Parallel::LCD_InitReady(void)
+{
+    if (_initState == InitRunning)
+    {
+        return false;
+    }
+    if (_initState == InitFramePending)
+    {
+        LCD_InitFirstFrame();
+    }
+    return true;
 }
 
 /*!
     @brief Sends a command to the display
     @param command Command to send
-    @param value the values to change
-    @note command and value will be combined with OR
  */
 void ST7565_Parallel::ST7565_send_command(uint8_t command)
 {
-
-    LCD_DC_LOW();
-    delay_us(UC1609_RESET_DELAY);
-    ST7565_write(command);
+    _bus->sendCommands(&command, 1);
 };
 
 /**
@@ -210,14 +354,43 @@ void ST7565_Parallel::ST7565_send_command(uint8_t command)
  */
 void ST7565_Parallel::ST7565_send_data(uint8_t data)
 {
-    // 设置命令/数据引脚（A0）为高电平
-    LCD_DC_HIGH();
-    // HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_SET); // A0
-    delay_us(UC1609_RESET_DELAY);
-    // delay_us(DELAY_US);
+    _bus->sendData(&data, 1);
+    LCD_ShadowAdvance(1);
+}
+
+/*!
+    @brief Send a run of command bytes in one bus transaction
+    @param commands pointer to the command bytes
+    @param len number of command bytes
+    @note The commands are not decoded, the controller state shadow is dropped.
+ */
+void ST7565_Parallel::ST7565_send_command_burst(const uint8_t *commands, uint16_t len)
+{
+    _bus->sendCommands(commands, len);
+    LCDShadowInvalidate();
+}
+
+/*!
+    @brief Send a run of display data bytes in one bus transaction
+    @param data pointer to the data bytes
+    @param len number of data bytes
+    @note A0 is set and CS asserted once, then only WR strobes per byte.
+ */
+void ST7565_Parallel::ST7565_send_data_burst(const uint8_t *data, uint16_t len)
+{
+    _bus->sendData(data, len);
+    LCD_ShadowAdvance(len);
+}
 
-    // 调用写入数据的函数，将数据发送到显示器
-    ST7565_write(data);
+/*!
+    @brief Send the same display data byte len times in one bus transaction
+    @param pattern the data byte to repeat
+    @param len number of data bytes
+ */
+void ST7565_Parallel::ST7565_send_data_fill(uint8_t pattern, uint16_t len)
+{
+    _bus->fillData(pattern, len);
+    LCD_ShadowAdvance(len);
 }
 
 /**
@@ -231,7 +404,7 @@ void ST7565_Parallel::ST7565_send_data(uint8_t data)
  */
 void ST7565_Parallel::LCD_SetPage(uint8_t page)
 {
-    ST7565_send_command(CMD_SET_PAGE | page);
+    LCD_SetPageColumn(page, _shadow.column);
 }
 
 /**
@@ -243,104 +416,427 @@ void ST7565_Parallel::LCD_SetPage(uint8_t page)
  */
 void ST7565_Parallel::LCD_SetColumn(uint8_t column)
 {
-    // 设置列地址低4位
-    ST7565_send_command(CMD_SET_COLUMN_LOWER | (column & 0x0F));
-
-    // 设置列地址高4位
-    ST7565_send_command(CMD_SET_COLUMN_UPPER | ((column >> 4) & 0x0F));
+    // 页地址保持不变，只发送变化的列地址半字节
+    LCD_SetPageColumn(LCD_SHADOW_UNKNOWN, column);
 }
 
 /*!
-    @brief Resets LCD in a four wire setup called at start
-    and should also be called in a controlled power down setting
+    @brief Set page and column address with one command burst
+    @param page page address 0-8
+    @param column column address 0-131
+    @note Address bytes the controller already holds are not sent.
  */
-void ST7565_Parallel::LCDReset()
+void ST7565_Parallel::LCD_SetPageColumn(uint8_t page, uint8_t column)
 {
-    // 将LCD的复位引脚拉低
-    LCD_RST_LOW();
-    // 延时一段时间，等待LCD复位完成
-    delay_ms(UC1609_INIT_DELAY);
-    // 将LCD的复位引脚拉高
-    LCD_RST_HIGH();
+    uint8_t commands[3];
+    uint8_t n = LCD_AddressCommands(page, column, commands);
+    if (n > 0)
+    {
+        _bus->sendCommands(commands, n);
+    }
 }
 
-/**
- * @brief 设置LCD显示模式
- *
- * 根据传入的模式参数设置LCD的显示模式。
- *
- * @param set_mode 显示模式，0表示正常显示，1表示反转显示
+/*!
+    @brief Build the address commands needed to reach page/column and update the shadow
+    @param page page address 0-8, LCD_SHADOW_UNKNOWN leaves the page alone
+    @param column column address 0-131, LCD_SHADOW_UNKNOWN leaves the column alone
+    @param commands receives up to 3 command bytes
+    @return number of command bytes to send
  */
-void ST7565_Parallel::LCD_Mode(uint8_t set_mode)
+uint8_t ST7565_Parallel::LCD_AddressCommands(uint8_t page, uint8_t column, uint8_t *commands)
 {
-    if (set_mode == 0)
+    uint8_t n = 0;
+    if (page == LCD_SHADOW_UNKNOWN)
     {
-        ST7565_send_command(CMD_SET_DISP_NORMAL);
     }
-    if (set_mode == 1)
+    else if (page != _shadow.page)
+    {
+        commands[n++] = CMD_SET_PAGE | page;
+        _shadow.page = page;
+    }
+    else
+    {
+        _elidedBytes++;
+    }
+    if (column == LCD_SHADOW_UNKNOWN)
+    {
+        return n;
+    }
+
+    // 列地址高低半字节分别比较，相同的半字节不再发送
+    bool known = (_shadow.column != LCD_SHADOW_UNKNOWN);
+    if (!known || ((column ^ _shadow.column) & 0x0F))
+    {
+        commands[n++] = CMD_SET_COLUMN_LOWER | (column & 0x0F);
+    }
+    else
+    {
+        _elidedBytes++;
+    }
+    if (!known || ((column ^ _shadow.column) & 0xF0))
     {
-        ST7565_send_command(CMD_SET_DISP_REVERSE);
+        commands[n++] = CMD_SET_COLUMN_UPPER | ((column >> 4) & 0x0F);
     }
+    else
+    {
+        _elidedBytes++;
+    }
+    _shadow.column = column;
+    return n;
 }
 
-void ST7565_Parallel::LCD_Contrast(uint8_t val)
+/*!
+    @brief Send a state command unless the controller already holds it
+    @param command the command byte
+    @param shadow the shadow field the command sets
+    @return true if the command was sent
+ */
+bool ST7565_Parallel::LCD_CommandShadowed(uint8_t command, uint8_t *shadow)
 {
-    // 关闭显示
-    ST7565_send_command(CMD_DISPLAY_OFF);
-    ST7565_send_command(CMD_SET_VOLUME_FIRST);
-    ST7565_send_command(CMD_SET_VOLUME_SECOND | (val & 0x3f));
-    ST7565_send_command(CMD_DISPLAY_ON);
+    if (*shadow == command)
+    {
+        _elidedBytes++;
+        return false;
+    }
+    ST7565_send_command(command);
+    *shadow = command;
+    return true;
 }
 
-// /*!
-//     @brief Powerdown procedure for LCD see datasheet P40
-//  */
-// void ST7565_Parallel::LCDPowerDown()
-// {
-//     LCDReset();
-//     LCDEnable(0);
-// }
-
-void ST7565_Parallel::LCD_Sleep_Disable(void)
+/*!
+    @brief Follow the column auto-increment after len data bytes
+    @param len number of data bytes written
+ */
+void ST7565_Parallel::LCD_ShadowAdvance(uint16_t len)
 {
-    // Re-enable booster circuit
-    ST7565_send_command(CMD_SET_POWER_CONTROL | 0x07); // Adjust value as needed
-
-    // Restore contrast (you may want to store the previous contrast value)
-    ST7565_send_command(CMD_SET_VOLUME_FIRST);
-    ST7565_send_command(0x20); // Adjust to your default contrast value
-
-    // Set display to normal mode
-    ST7565_send_command(CMD_SET_ALLPTS_NORMAL);
+    if (_shadow.column == LCD_SHADOW_UNKNOWN)
+    {
+        return;
+    }
+    // 列计数器停在最后一列，越界后状态未知
+    uint16_t column = _shadow.column + len;
+    _shadow.column = (column < LCD_COLUMNS) ? column : LCD_SHADOW_UNKNOWN;
+}
 
-    // Turn on display
-    ST7565_send_command(CMD_DISPLAY_ON);
+/*!
+    @brief Forget the controller state shadow, every following command is sent
+    @note Call after talking to the controller behind the driver's back.
+ */
+void ST7565_Parallel::LCDShadowInvalidate()
+{
+    _shadow.page = LCD_SHADOW_UNKNOWN;
+    _shadow.column = LCD_SHADOW_UNKNOWN;
+    _shadow.contrast = LCD_SHADOW_UNKNOWN;
+    _shadow.display = LCD_SHADOW_UNKNOWN;
+    _shadow.mode = LCD_SHADOW_UNKNOWN;
+    _shadow.allPoints = LCD_SHADOW_UNKNOWN;
+    _shadow.power = LCD_SHADOW_UNKNOWN;
+    _shadow.startLine = LCD_SHADOW_UNKNOWN;
+}
 
-    // Optional: Re-initialize display if needed
-    // ST7565_init();  // Call your initialization function if necessary
+/*!
+    @brief Getter for the command bytes the shadow has saved
+    @return bytes skipped since the start of the last LCDupdate, LCDupdateAsync or LCDupdateIT
+ */
+uint32_t ST7565_Parallel::LCDElidedBytesGet()
+{
+    return _elidedBytes;
 }
 
-void ST7565_Parallel::LCD_Sleep_Enable(void)
+/*!
+    @brief Mark the whole active buffer and the icon row as changed
+    @note Call when the glass no longer shows what the buffers hold, e.g. after
+    writing to the controller directly. LCDReset, LCDFillScreen and LCDBitmap
+    call it, the next update then sends every visible byte.
+ */
+void ST7565_Parallel::LCDinvalidateAll()
 {
-    // Turn off display
-    ST7565_send_command(CMD_DISPLAY_OFF);
+    // 最大值按 0xFF 记录，发送时再裁剪到可见列
+    for (uint8_t row = 0; row < LCD_DIRTY_ROWS; row++)
+    {
+        _dirtyMin[row] = 0;
+        _dirtyMax[row] = 0xFF;
+    }
+    if (_InactiveBuffer != nullptr)
+    {
+        _iconDirtyMin = 0;
+        _iconDirtyMax = _iconwidthScreen - 1;
+    }
+    // 玻璃内容未知，影子缓冲区在下一帧整帧发出后才可用于比较
+    _diffValid = false;
+}
 
-    // Set all pixels on (this reduces power consumption in some LCDs)
-    ST7565_send_command(CMD_SET_ALLPTS_ON);
+/*!
+    @brief Select how LCDupdate finds the bytes that really changed
+    @param mode LCD_Diff_Off sends every dirty column, LCD_Diff_Shadow keeps a
+    copy of the glass (width * height / 8 + 128 bytes) and sends only the bytes
+    that differ, LCD_Diff_Hash keeps a CRC-32 per LCD_CHUNK_BYTES columns
+    (4 / LCD_CHUNK_BYTES of the shadow RAM) and skips chunks that hash as before
+    @return LCD_BusBusy while a frame is going out, LCD_Success otherwise
+    @note The first frame after a change sends every visible byte.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDDiffModeSet(LCD_DiffMode_e mode)
+{
+    if (_asyncBusy)
+    {
+        return LCD_BusBusy;
+    }
+    delete[] _diffShadow;
+    delete[] _diffHash;
+    _diffShadow = nullptr;
+    _diffHash = nullptr;
+    if (mode == LCD_Diff_Shadow)
+    {
+        _diffShadow = new uint8_t[_bufferSize + _iconwidthScreen];
+    }
+    else if (mode == LCD_Diff_Hash)
+    {
+#ifndef LCD_CRC_SOFTWARE
+        __HAL_RCC_CRC_CLK_ENABLE();
+#endif
+        _diffHash = new uint32_t[LCD_CHUNKS_PER_PAGE * (_heightScreen / 8 + 1)];
+    }
+    _diffMode = mode;
+    LCDinvalidateAll();
+    return LCD_Success;
+}
 
-    // Disable booster circuit
-    ST7565_send_command(CMD_SET_POWER_CONTROL | 0x00);
+/*!
+    @brief Getter for the change detection mode
+    @return LCD_DiffMode_e enum
+ */
+LCD_DiffMode_e ST7565_Parallel::LCDDiffModeGet()
+{
+    return _diffMode;
+}
 
-    // Set lower contrast to reduce power consumption
-    ST7565_send_command(CMD_SET_VOLUME_FIRST);
-    ST7565_send_command(0); // Lowest contrast value
+/*!
+    @brief Set the longest run of unchanged bytes sent to join two changed runs
+    @param bytes gap in bytes, default LCD_DIFF_MERGE_GAP
+    @note A new run costs up to two column address bytes plus the burst setup
+    of the bus, a slow bus setup (SPI DMA) favours a larger gap.
+ */
+void ST7565_Parallel::LCDDiffMergeGapSet(uint8_t bytes)
+{
+    _diffMergeGap = bytes;
+}
 
-    // Optional: Turn off voltage regulator
-    ST7565_send_command(CMD_SET_STATIC_OFF);
+/*!
+    @brief Getter for the merge gap
+    @return gap in bytes
+ */
+uint8_t ST7565_Parallel::LCDDiffMergeGapGet()
+{
+    return _diffMergeGap;
 }
 
-// /*!
-//     @brief Turns On Display
+/*!
+    @brief Getter for the bytes the diff saved
+    @return dirty bytes of the last frame that already matched the glass and were not sent
+ */
+uint32_t ST7565_Parallel::LCDDiffSavedBytesGet()
+{
+    return _diffSavedBytes;
+}
+
+/*!
+    @brief Getter for the RAM the change detection uses
+    @return bytes allocated by LCDDiffModeSet
+ */
+uint32_t ST7565_Parallel::LCDDiffRamGet()
+{
+    if (_diffShadow != nullptr)
+    {
+        return _bufferSize + _iconwidthScreen;
+    }
+    if (_diffHash != nullptr)
+    {
+        return LCD_CHUNKS_PER_PAGE * (_heightScreen / 8 + 1) * sizeof(uint32_t);
+    }
+    return 0;
+}
+
+/*!
+    @brief Getter for the chunks hashed in the last frame
+    @return chunks compared with their last sent hash, LCD_Diff_Hash only
+ */
+uint32_t ST7565_Parallel::LCDDiffChunksGet()
+{
+    return _diffChunks;
+}
+
+/*!
+    @brief Getter for the chunks skipped in the last frame
+    @return chunks whose hash matched, the hit rate is this over LCDDiffChunksGet
+ */
+uint32_t ST7565_Parallel::LCDDiffChunkHitsGet()
+{
+    return _diffChunkHits;
+}
+
+/*!
+    @brief Choose between bit-band and byte read-modify-write pixel writes
+    @param enable true (default) writes pixels of buffers in SRAM through the
+    bit-band alias, false always uses the portable byte path
+    @note Has no effect in builds with LCD_BITBAND_OFF (host tests).
+ */
+void ST7565_Parallel::LCDBitBandSet(bool enable)
+{
+    _bitBand = enable;
+}
+
+/*!
+    @brief Getter for the pixel write path
+    @return true if buffers in SRAM are written through the bit-band alias
+ */
+bool ST7565_Parallel::LCDBitBandGet()
+{
+#ifdef LCD_BITBAND_OFF
+    return false;
+#else
+    return _bitBand;
+#endif
+}
+
+/*!
+    @brief Getter for the display data of the last frame
+    @return data bytes sent by the last LCDupdate, LCDupdateAsync or LCDupdateIT
+ */
+uint32_t ST7565_Parallel::LCDUpdateBytesGet()
+{
+    return _updateBytes;
+}
+
+/*!
+    @brief Mark icon row columns as changed
+    @param first first column written
+    @param last last column written
+ */
+void ST7565_Parallel::LCD_IconDirty(uint8_t first, uint8_t last)
+{
+    if (_InactiveBuffer == nullptr)
+    {
+        return;
+    }
+    if (_iconDirtyMin > _iconDirtyMax)
+    {
+        _iconDirtyMin = first;
+        _iconDirtyMax = last;
+        return;
+    }
+    if (first < _iconDirtyMin)
+    {
+        _iconDirtyMin = first;
+    }
+    if (last > _iconDirtyMax)
+    {
+        _iconDirtyMax = last;
+    }
+}
+
+/*!
+    @brief Resets LCD in a four wire setup called at start
+    and should also be called in a controlled power down setting
+ */
+void ST7565_Parallel::LCDReset()
+{
+    // 将LCD的复位引脚拉低
+    _bus->reset(true);
+    LCDShadowInvalidate();
+    LCDinvalidateAll();
+    // 延时一段时间，等待LCD复位完成
+    delay_ms(UC1609_INIT_DELAY);
+    // 将LCD的复位引脚拉高
+    _bus->reset(false);
+}
+
+/**
+ * @brief 设置LCD显示模式
+ *
+ * 根据传入的模式参数设置LCD的显示模式。
+ *
+ * @param set_mode 显示模式，0表示正常显示，1表示反转显示
+ */
+void ST7565_Parallel::LCD_Mode(uint8_t set_mode)
+{
+    if (set_mode == 0)
+    {
+        LCD_CommandShadowed(CMD_SET_DISP_NORMAL, &_shadow.mode);
+    }
+    if (set_mode == 1)
+    {
+        LCD_CommandShadowed(CMD_SET_DISP_REVERSE, &_shadow.mode);
+    }
+}
+
+void ST7565_Parallel::LCD_Contrast(uint8_t val)
+{
+    // 对比度未变化时只需保证显示开启
+    if (_shadow.contrast == (val & 0x3f))
+    {
+        _elidedBytes += 3;
+        LCD_CommandShadowed(CMD_DISPLAY_ON, &_shadow.display);
+        return;
+    }
+    // 关闭显示
+    LCD_CommandShadowed(CMD_DISPLAY_OFF, &_shadow.display);
+    ST7565_send_command(CMD_SET_VOLUME_FIRST);
+    ST7565_send_command(CMD_SET_VOLUME_SECOND | (val & 0x3f));
+    _shadow.contrast = val & 0x3f;
+    LCD_CommandShadowed(CMD_DISPLAY_ON, &_shadow.display);
+}
+
+// /*!
+//     @brief Powerdown procedure for LCD see datasheet P40
+//  */
+// void ST7565_Parallel::LCDPowerDown()
+// {
+//     LCDReset();
+//     LCDEnable(0);
+// }
+
+void ST7565_Parallel::LCD_Sleep_Disable(void)
+{
+    // Re-enable booster circuit
+    LCD_CommandShadowed(CMD_SET_POWER_CONTROL | 0x07, &_shadow.power); // Adjust value as needed
+
+    // Restore contrast (you may want to store the previous contrast value)
+    ST7565_send_command(CMD_SET_VOLUME_FIRST);
+    ST7565_send_command(0x20); // Adjust to your default contrast value
+    _shadow.contrast = 0x20;
+
+    // Set display to normal mode
+    LCD_CommandShadowed(CMD_SET_ALLPTS_NORMAL, &_shadow.allPoints);
+
+    // Turn on display
+    LCD_CommandShadowed(CMD_DISPLAY_ON, &_shadow.display);
+
+    // Optional: Re-initialize display if needed
+    // ST7565_init();  // Call your initialization function if necessary
+}
+
+void ST7565_Parallel::LCD_Sleep_Enable(void)
+{
+    // Turn off display
+    LCD_CommandShadowed(CMD_DISPLAY_OFF, &_shadow.display);
+
+    // Set all pixels on (this reduces power consumption in some LCDs)
+    LCD_CommandShadowed(CMD_SET_ALLPTS_ON, &_shadow.allPoints);
+
+    // Disable booster circuit
+    LCD_CommandShadowed(CMD_SET_POWER_CONTROL | 0x00, &_shadow.power);
+
+    // Set lower contrast to reduce power consumption
+    ST7565_send_command(CMD_SET_VOLUME_FIRST);
+    ST7565_send_command(0); // Lowest contrast value
+    _shadow.contrast = 0;
+
+    // Optional: Turn off voltage regulator
+    ST7565_send_command(CMD_SET_STATIC_OFF);
+}
+
+// /*!
+//     @brief Turns On Display
 //     @param bits 1 display on , 0 display off
 //  */
 // /**
@@ -359,19 +855,304 @@ void ST7565_Parallel::LCD_Sleep_Enable(void)
 //     LCD_CS_HIGH();
 // }
 
-// /*!
-//     @brief Scroll the displayed image up by SL rows.
-//     @details The valid SL value is between 0 (for no
-//     scrolling) and (64).
-//     Setting SL outside of this range causes undefined effect on the displayed image.
-//     @param bits 0-64 line number y-axis
-//  */
-// void ST7565_Parallel::LCDscroll(uint8_t bits)
-// {
-//     LCD_CS_LOW();
-//     send_command(UC1609_SCROLL, bits);
-//     LCD_CS_HIGH();
-// }
+/*!
+    @brief Scroll the picture with the controller start line, the buffer is used as a ring
+    @param lines rows to move the picture up, negative moves it down
+    @return LCD_BusBusy during an asynchronous update, LCD_ScrollRange unless
+    ActiveBuffer is a full height screen at y offset 0, LCD_Success otherwise
+    @note Costs one command. The rows scrolled in are cleared in the buffer and
+    marked dirty; draw them (at the bottom, or the top for negative lines) and
+    LCDupdate sends just those pages. drawPixel follows the moving origin.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDscroll(int8_t lines)
+{
+    if (_asyncBusy)
+    {
+        return LCD_BusBusy;
+    }
+    ST7565_Parallel_Screen *screen = this->ActiveBuffer;
+    if (screen == nullptr || screen->height != LCD_SCROLL_LINES || screen->yoffset != 0 || _heightScreen != LCD_SCROLL_LINES ||
+        _transposeBuffer != nullptr)
+    {
+        return LCD_ScrollRange;
+    }
+    uint8_t count = (lines < 0) ? -lines : lines;
+    if (count > LCD_SCROLL_LINES)
+    {
+        count = LCD_SCROLL_LINES;
+    }
+    uint8_t first;
+    if (lines > 0)
+    {
+        // 原来顶部的行移到底部
+        first = _scrollLine;
+        _scrollLine = (_scrollLine + count) & (LCD_SCROLL_LINES - 1);
+    }
+    else
+    {
+        // 原来底部的行移到顶部
+        _scrollLine = (_scrollLine - count) & (LCD_SCROLL_LINES - 1);
+        first = _scrollLine;
+    }
+    LCD_ScrollClear(first, count);
+    LCD_CommandShadowed(CMD_SET_DISP_START_LINE | _scrollLine, &_shadow.startLine);
+    return LCD_Success;
+}
+
+/*!
+    @brief Getter for the scroll position
+    @return controller start line 0-63, the buffer line shown in the top screen row
+ */
+uint8_t ST7565_Parallel::LCDscrollGet()
+{
+    return _scrollLine;
+}
+
+/*!
+    @brief Clear buffer lines that scrolled into view and mark their rows dirty
+    @param first first buffer line
+    @param count lines, wrapping at LCD_SCROLL_LINES
+ */
+void ST7565_Parallel::LCD_ScrollClear(uint8_t first, uint8_t count)
+{
+    uint8_t masks[LCD_DIRTY_ROWS] = {0};
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint8_t line = (first + i) & (LCD_SCROLL_LINES - 1);
+        masks[line >> 3] |= (1 << (line & 7));
+    }
+    ST7565_Parallel_Screen *screen = this->ActiveBuffer;
+    for (uint8_t row = 0; row < LCD_DIRTY_ROWS; row++)
+    {
+        if (masks[row] == 0)
+        {
+            continue;
+        }
+        uint8_t *line = &screen->screenBuffer[screen->width * row];
+        for (uint8_t x = 0; x < screen->width; x++)
+        {
+            line[x] &= ~masks[row];
+        }
+        _drawDirtyMin[row] = 0;
+        _drawDirtyMax[row] = 0xFF;
+    }
+}
+
+/*!
+    @brief Draw portrait (90 or 270 degrees) into a buffer in rotated page
+    order and transpose it to panel page order before each update
+    @param portrait WIDTH * HEIGHT / 8 bytes, pages of 8 rows across the
+    rotated width, nullptr goes back to rotating each pixel
+    @param rotation LCD_Degrees_90 or LCD_Degrees_270
+    @return LCD_BusBusy while a frame is going out, LCD_TransposeRange for
+    other rotations, a screen that is not the whole panel, a width that is not
+    whole 8x8 blocks, a scrolled screen or strip mode, LCD_Success otherwise
+    @note Pixels are written without a coordinate transform. Only the 8x8
+    blocks drawn since the last flush are transposed, see LCDTransposeFlush.
+    The portrait buffer starts blank. setRotation ends the mode.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDTransposeSet(uint8_t *portrait, LCD_rotate_e rotation)
+{
+    if (_asyncBusy)
+    {
+        return LCD_BusBusy;
+    }
+    if (portrait == nullptr)
+    {
+        // 先把未转置的块写回面板缓冲区
+        LCDTransposeFlush();
+        setRotation(getRotation());
+        return LCD_Success;
+    }
+    ST7565_Parallel_Screen *screen = this->ActiveBuffer;
+    if ((rotation != LCD_Degrees_90 && rotation != LCD_Degrees_270) || screen == nullptr ||
+        screen->width != WIDTH || screen->height != HEIGHT || (WIDTH % 8) != 0 ||
+        WIDTH / 8 > LCD_TRANSPOSE_PAGES || _scrollLine != 0 || _strip != nullptr)
+    {
+        return LCD_TransposeRange;
+    }
+    setRotation(rotation);
+    memset(portrait, 0x00, WIDTH * (HEIGHT / 8));
+    // 所有块标为已画，第一次刷新得到与竖屏缓冲区一致的空白画面
+    for (uint8_t page = 0; page < LCD_TRANSPOSE_PAGES; page++)
+    {
+        _transposeDirty[page] = (page < WIDTH / 8) ? (uint8_t)(0xFF >> (8 - HEIGHT / 8)) : 0;
+    }
+    _transposeBuffer = portrait;
+    _transposeRotation = rotation;
+    _pixelWriter = &ST7565_Parallel::LCD_PixelTransposed;
+    return LCD_Success;
+}
+
+/*!
+    @brief Transpose one 8x8 bit block, Hacker's Delight transpose8
+    @param x rows 0-3 of the block, row 0 in the top byte
+    @param y rows 4-7
+    @note Three swap stages on two 32-bit words, no per-bit loop.
+ */
+static inline void LCD_Transpose8(uint32_t &x, uint32_t &y)
+{
+    uint32_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+}
+
+/*!
+    @brief Transpose the portrait blocks drawn since the last call into the
+    active (back) buffer and mark the columns dirty
+    @return blocks transposed, 0 outside the transposed rotation
+    @note Called by the updates and LCDswap, call it directly only to time it.
+ */
+uint16_t ST7565_Parallel::LCDTransposeFlush()
+{
+    if (_transposeBuffer == nullptr)
+    {
+        return 0;
+    }
+    uint8_t *panel = this->ActiveBuffer->screenBuffer;
+    uint8_t pages = WIDTH / 8;
+    uint8_t groups = HEIGHT / 8;
+    uint16_t blocks = 0;
+    for (uint8_t page = 0; page < pages; page++)
+    {
+        uint8_t dirty = _transposeDirty[page];
+        _transposeDirty[page] = 0;
+        for (uint8_t group = 0; dirty != 0; group++, dirty >>= 1)
+        {
+            if ((dirty & 0x01) == 0)
+            {
+                continue;
+            }
+            // 一个块是竖屏缓冲区中连续的 8 字节，按小端读成两个字
+            uint32_t lo, hi, x, y;
+            memcpy(&lo, &_transposeBuffer[HEIGHT * page + 8 * group], 4);
+            memcpy(&hi, &_transposeBuffer[HEIGHT * page + 8 * group + 4], 4);
+            uint8_t row;
+            uint8_t column;
+            if (_transposeRotation == LCD_Degrees_90)
+            {
+                // 90 度：字节逆序输入，输出按原顺序
+                row = group;
+                column = WIDTH - 8 - 8 * page;
+                x = hi;
+                y = lo;
+                LCD_Transpose8(x, y);
+                lo = __builtin_bswap32(x);
+                hi = __builtin_bswap32(y);
+            }
+            else
+            {
+                // 270 度：字节顺序输入，输出逆序
+                row = groups - 1 - group;
+                column = 8 * page;
+                x = __builtin_bswap32(lo);
+                y = __builtin_bswap32(hi);
+                LCD_Transpose8(x, y);
+                lo = y;
+                hi = x;
+            }
+            memcpy(&panel[WIDTH * row + column], &lo, 4);
+            memcpy(&panel[WIDTH * row + column + 4], &hi, 4);
+            if (column < _drawDirtyMin[row])
+            {
+                _drawDirtyMin[row] = column;
+            }
+            if (column + 7 > _drawDirtyMax[row])
+            {
+                _drawDirtyMax[row] = column + 7;
+            }
+            blocks++;
+        }
+    }
+    _transposeBlocks = blocks;
+    return blocks;
+}
+
+/*!
+    @brief Getter for the blocks the last flush transposed
+    @return 8x8 blocks, a full frame is WIDTH * HEIGHT / 64
+ */
+uint16_t ST7565_Parallel::LCDTransposeBlocksGet()
+{
+    return _transposeBlocks;
+}
+
+/*!
+    @brief drawPixel in the transposed rotation, writes the portrait buffer as is
+    @param x x co-ord of pixel
+    @param y y co-ord of pixel
+    @param colour colour of pixel
+ */
+void ST7565_Parallel::LCD_PixelTransposed(int16_t x, int16_t y, uint8_t colour)
+{
+    if ((x < 0) || (x >= _width) || (y < 0) || (y >= _height))
+        return;
+    uint8_t page = (uint16_t)y >> 3;
+    _transposeDirty[page] |= (1 << ((uint16_t)x >> 3));
+    LCD_PixelWrite(&_transposeBuffer[HEIGHT * page + x], y & 7, colour);
+}
+
+/*!
+    @brief fillRect in the transposed rotation, page masks on the portrait buffer
+    @param x left edge
+    @param y top edge
+    @param w width, > 0
+    @param h height, > 0
+    @param colour FOREGROUND, BACKGROUND or COLORINVERSE
+ */
+void ST7565_Parallel::LCD_TransposeFill(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour)
+{
+    int16_t x0 = (x < 0) ? 0 : x;
+    int16_t y0 = (y < 0) ? 0 : y;
+    int16_t x1 = (x + w > _width) ? _width : x + w;
+    int16_t y1 = (y + h > _height) ? _height : y + h;
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    // 竖屏下的列块范围，各页相同
+    uint8_t blocks = (uint8_t)((0xFF << (x0 >> 3)) & (0xFF >> (7 - ((x1 - 1) >> 3))));
+    int16_t len = x1 - x0;
+    uint8_t lastPage = (y1 - 1) >> 3;
+    for (uint8_t page = y0 >> 3; page <= lastPage; page++)
+    {
+        uint8_t mask = 0xFF;
+        if (page == (y0 >> 3))
+        {
+            mask &= (uint8_t)(0xFF << (y0 & 7));
+        }
+        if (page == lastPage)
+        {
+            mask &= (uint8_t)(0xFF >> (7 - ((y1 - 1) & 7)));
+        }
+        _transposeDirty[page] |= blocks;
+        uint8_t *target = &_transposeBuffer[HEIGHT * page + x0];
+        for (int16_t i = 0; i < len; i++)
+        {
+            switch (colour)
+            {
+            case FOREGROUND:
+                target[i] |= mask;
+                break;
+            case BACKGROUND:
+                target[i] &= ~mask;
+                break;
+            case COLORINVERSE:
+                target[i] ^= mask;
+                break;
+            }
+        }
+    }
+}
 
 // /*!
 //     @brief Rotates the display
@@ -410,7 +1191,7 @@ void ST7565_Parallel::LCD_Sleep_Enable(void)
  */
 void ST7565_Parallel::LCDInvertDisplay(uint8_t bits)
 {
-    ST7565_send_command(CMD_SET_DISP_REVERSE);
+    LCD_Mode(bits != 0);
 }
 
 /*!
@@ -420,7 +1201,7 @@ void ST7565_Parallel::LCDInvertDisplay(uint8_t bits)
  */
 void ST7565_Parallel::LCDallpixelsOn(uint8_t bits)
 {
-    ST7565_send_command(CMD_SET_DISP_REVERSE);
+    LCD_CommandShadowed(bits ? CMD_SET_ALLPTS_ON : CMD_SET_ALLPTS_NORMAL, &_shadow.allPoints);
 }
 
 /*!
@@ -430,17 +1211,16 @@ void ST7565_Parallel::LCDallpixelsOn(uint8_t bits)
  */
 void ST7565_Parallel::LCDFillScreen(uint8_t dataPattern)
 {
-
-    uint16_t numofbytes = _widthScreen * (_heightScreen / 8); // width * height
-    for (uint16_t i = 0; i < numofbytes; i++)
+    LCDinvalidateAll();
+    // 每页设置一次地址，然后整页突发写入
+    for (uint8_t page = 0; page < (_heightScreen / 8); page++)
     {
-        ST7565_send_data(dataPattern);
-    }
-    uint16_t iconnumofbytes = _iconwidthScreen * (_iconheightScreen / 8); // width * height
-    for (uint16_t i = 0; i < iconnumofbytes; i++)
-    {
-        ST7565_send_data(dataPattern);
+        LCD_SetPageColumn(page, 0);
+        ST7565_send_data_fill(dataPattern, _widthScreen);
     }
+    // 图标行（第 8 页）
+    LCD_SetPageColumn(_heightScreen / 8, 0);
+    ST7565_send_data_fill(dataPattern, _iconwidthScreen * (_iconheightScreen / 8));
 }
 
 /*!
@@ -450,12 +1230,9 @@ void ST7565_Parallel::LCDFillScreen(uint8_t dataPattern)
 void ST7565_Parallel::LCDFillPage(uint8_t dataPattern = 0)
 {
     uint16_t numofbytes = ((_widthScreen * (_heightScreen / 8)) / 8); // (width * height/8)/8 = 192 bytes
-    for (uint16_t i = 0; i < numofbytes; i++)
-    {
-
-        ST7565_send_data(dataPattern);
-    }
-}
+    LCDinvalidateAll();
+    ST7565_send_data_fill(dataPattern, numofbytes);
+}
 
 /*!
     @brief Goes to X Y position
@@ -469,8 +1246,7 @@ void ST7565_Parallel::LCDGotoXY(uint8_t column, uint8_t page)
     // send_command(UC1609_SET_COLADD_MSB, (column & 0xF0) >> 4);
     // send_command(UC1609_SET_PAGEADD, page++);
 
-    LCD_SetPage(page++);
-    LCD_SetColumn(column);
+    LCD_SetPageColumn(page, column);
 }
 
 /*!
@@ -487,131 +1263,1683 @@ LCD_Return_Codes_e ST7565_Parallel::LCDBitmap(int16_t x, int16_t y, uint8_t w, u
     // User error checks
     if (data == nullptr)
     {
-        return LCD_BitmapNullptr;
+        return LCD_BitmapNullptr;
+    }
+    if (x > _width || y > _height)
+    {
+        return LCD_BitmapScreenBounds;
+    }
+    if (w > _width || h > _height)
+    {
+        return LCD_BitmapLargerThanScreen;
+    }
+    if ((h % 8 != 0))
+    {
+        return LCD_BitmapVerticalSize;
+    }
+    // 直接写屏，玻璃上的内容不再与缓冲区一致
+    LCDinvalidateAll();
+
+    uint8_t ty;
+    uint8_t column = (x < 0) ? 0 : x;
+    uint8_t page = (y < 0) ? 0 : y >> 3;
+    // 每页只传输屏幕内可见的列
+    int16_t first = (x < 0) ? -x : 0;
+    int16_t last = (x + w > _widthScreen) ? _widthScreen - x : w;
+
+    for (ty = 0; ty < h; ty = ty + 8)
+    {
+        if (y + ty < 0 || y + ty >= _heightScreen)
+        {
+            continue;
+        }
+        LCD_SetPageColumn(page++, column);
+        if (first < last)
+        {
+            ST7565_send_data_burst(&data[(w * (ty >> 3)) + first], last - first);
+        }
+    }
+    // LCD_CS_HIGH();
+    return LCD_Success;
+}
+
+/*!
+    @brief updates the LCD i.e. writes the shared buffer to the active screen
+    pointed to by ActiveBuffer
+    @note Only the columns changed since the last update are sent, see LCDinvalidateAll.
+    Does nothing while LCDbeginAsync is still sending the power-on sequence.
+ */
+void ST7565_Parallel::LCDupdate()
+{
+    // 上电序列还在 SysTick 中发送命令
+    if (_initState == InitRunning)
+    {
+        return;
+    }
+    // LCDbeginAsync 之后的第一帧
+    if (_initState == InitFramePending)
+    {
+        LCD_InitFirstFrame();
+        return;
+    }
+    // 等待未完成的异步刷新
+    while (_asyncBusy)
+    {
+    }
+    // 只发送各行的脏列范围
+    LCD_FrameStart();
+    while (LCD_AsyncNextRow())
+    {
+        LCD_SetPageColumn(_asyncCur.page, _asyncCur.column);
+        ST7565_send_data_burst(_asyncCur.data, _asyncCur.len);
+    }
+}
+
+/*!
+    @brief Write one rectangle of the active buffer to the screen
+    @param x left edge in drawing coordinates
+    @param y top edge, rounded down to a page boundary
+    @param w width in pixels
+    @param h height, the bottom is rounded up to a page boundary
+    @note Sends the covered columns of the covered pages at the screen's x/y
+    offsets, whether or not they are dirty and whether or not the shadow or
+    hash diff sees them as already on the glass, so a region also repairs a
+    glass that went out of sync. The icon row is not sent.
+ */
+void ST7565_Parallel::LCDupdateRegion(int16_t x, int16_t y, uint8_t w, uint8_t h)
+{
+    LCD_Rect_t rect = {x, y, w, h};
+    LCDupdateRegions(&rect, 1);
+}
+
+/*!
+    @brief Write several rectangles of the active buffer to the screen in one pass
+    @param rects the rectangles in drawing coordinates
+    @param count number of rectangles
+    @note Per page, overlapping rectangles (and those closer than the merge gap,
+    see LCDDiffMergeGapSet) are coalesced into one address setup and burst.
+    The diff mode does not filter the bytes, it only records what was sent;
+    LCD_Diff_Hash widens the spans to whole chunks. Does nothing while
+    LCDbeginAsync is still sending the power-on sequence.
+ */
+void ST7565_Parallel::LCDupdateRegions(const LCD_Rect_t *rects, uint8_t count)
+{
+    if (rects == nullptr || count == 0 || !LCD_InitReady())
+    {
+        return;
+    }
+    // 等待未完成的异步刷新
+    while (_asyncBusy)
+    {
+    }
+    // 区域整段发送，影子缓冲区（或块哈希）只记录发出的内容
+    bool diffValid = _diffValid;
+    _regionRects = rects;
+    _regionCount = count;
+    _regionColumn = 0;
+    LCD_FrameStart();
+    _diffValid = false;
+    while (LCD_AsyncNextRow())
+    {
+        LCD_SetPageColumn(_asyncCur.page, _asyncCur.column);
+        ST7565_send_data_burst(_asyncCur.data, _asyncCur.len);
+    }
+    _regionCount = 0;
+    _diffValid = diffValid;
+}
+
+/*!
+    @brief Give the active screen a second (front) buffer, drawing then goes to
+    the screen's own buffer and updates send the front buffer
+    @param front buffer of the same size as ActiveBuffer's, nullptr returns to a single buffer
+    @param copyBack true makes LCDswap copy the changed columns into the new
+    back buffer, so drawing can continue from the last frame
+    @return LCD_BusBusy while a frame is going out, LCD_ScreenNullptr if
+    front is given but ActiveBuffer is not set, LCD_Success otherwise
+    @note The front buffer starts as a copy of the screen buffer. The icon row
+    stays single buffered.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDDoubleBufferSet(uint8_t *front, bool copyBack)
+{
+    if (_asyncBusy)
+    {
+        return LCD_BusBusy;
+    }
+    ST7565_Parallel_Screen *screen = this->ActiveBuffer;
+    if (front != nullptr && screen == nullptr)
+    {
+        return LCD_ScreenNullptr;
+    }
+    // 未交换的绘图修改并入发送侧
+    LCD_DirtyMergeBack();
+    _drawDirtyMin = _dirtyMin;
+    _drawDirtyMax = _dirtyMax;
+    _frontScreen = nullptr;
+    _frontBuffer = nullptr;
+    if (front == nullptr)
+    {
+        return LCD_Success;
+    }
+
+    memcpy(front, screen->screenBuffer, screen->width * (screen->height / 8));
+    for (uint8_t row = 0; row < LCD_DIRTY_ROWS; row++)
+    {
+        _backDirtyMin[row] = 0xFF;
+        _backDirtyMax[row] = 0;
+    }
+    _drawDirtyMin = _backDirtyMin;
+    _drawDirtyMax = _backDirtyMax;
+    _frontScreen = screen;
+    _frontBuffer = front;
+    _copyBack = copyBack;
+    return LCD_Success;
+}
+
+/*!
+    @brief Make the drawn (back) buffer the front buffer the updates send
+    @return LCD_BusBusy while the front buffer is still going out,
+    LCD_BusUnsupported without LCDDoubleBufferSet, LCD_Success otherwise
+    @note Follow with LCDupdateAsync (or LCDupdate) and draw the next frame
+    while it goes out. With copyBack only the columns drawn since the last
+    swap are copied into the new back buffer.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDswap()
+{
+    if (_frontScreen == nullptr)
+    {
+        return LCD_BusUnsupported;
+    }
+    if (_asyncBusy)
+    {
+        return LCD_BusBusy;
+    }
+    LCDTransposeFlush();
+    uint8_t *front = _frontScreen->screenBuffer;
+    uint8_t *back = _frontBuffer;
+    _frontBuffer = front;
+    _frontScreen->screenBuffer = back;
+
+    if (_copyBack)
+    {
+        // 新后台缓冲区是上一帧，只补上本帧画过的列
+        uint8_t width = _frontScreen->width;
+        uint8_t rows = _frontScreen->height / 8;
+        for (uint8_t row = 0; row < rows; row++)
+        {
+            uint16_t from = 0;
+            uint16_t to = width;
+            if (row < LCD_DIRTY_ROWS)
+            {
+                from = _backDirtyMin[row];
+                to = (_backDirtyMax[row] + 1 < width) ? _backDirtyMax[row] + 1 : width;
+            }
+            if (from < to)
+            {
+                memcpy(&back[width * row + from], &front[width * row + from], to - from);
+            }
+        }
+    }
+    LCD_DirtyMergeBack();
+    return LCD_Success;
+}
+
+/*!
+    @brief Getter for the buffer the updates send
+    @return the front buffer, or the active screen buffer without double buffering
+ */
+uint8_t *ST7565_Parallel::LCDFrontBufferGet()
+{
+    return (_frontScreen != nullptr) ? _frontBuffer : this->ActiveBuffer->screenBuffer;
+}
+
+/*!
+    @brief Move the back buffer dirty ranges into the ranges the updates send
+ */
+void ST7565_Parallel::LCD_DirtyMergeBack()
+{
+    if (_drawDirtyMin == _dirtyMin)
+    {
+        return;
+    }
+    for (uint8_t row = 0; row < LCD_DIRTY_ROWS; row++)
+    {
+        if (_backDirtyMin[row] > _backDirtyMax[row])
+        {
+            continue;
+        }
+        if (_backDirtyMin[row] < _dirtyMin[row])
+        {
+            _dirtyMin[row] = _backDirtyMin[row];
+        }
+        if (_backDirtyMax[row] > _dirtyMax[row] || _dirtyMin[row] > _dirtyMax[row])
+        {
+            _dirtyMax[row] = _backDirtyMax[row];
+        }
+        _backDirtyMin[row] = 0xFF;
+        _backDirtyMax[row] = 0;
+    }
+}
+
+/*!
+    @brief Switch to page strip rendering, no full frame buffer is needed
+    @param list array receiving the draw calls
+    @param size number of items in list
+    @param strip one page of _widthScreen bytes
+    @return LCD_BitmapNullptr for a missing array, LCD_Success otherwise
+    @note Record the frame with the LCDList functions, LCDupdateStrip then
+    replays the list once per page into the strip and sends it. RAM is
+    width + 16 * size bytes instead of width * height / 8.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDStripBegin(LCD_ListItem_t *list, uint16_t size, uint8_t *strip)
+{
+    if (list == nullptr || strip == nullptr)
+    {
+        return LCD_BitmapNullptr;
+    }
+    _list = list;
+    _listSize = size;
+    _listLength = 0;
+    _strip = strip;
+    return LCD_Success;
+}
+
+/*!
+    @brief Empty the display list, the next frame starts from a blank screen
+ */
+void ST7565_Parallel::LCDListClear()
+{
+    _listLength = 0;
+}
+
+/*!
+    @brief Getter for the recorded draw calls
+    @return items in the display list
+ */
+uint16_t ST7565_Parallel::LCDListLengthGet()
+{
+    return _listLength;
+}
+
+/*!
+    @brief Record a pixel, see drawPixel
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDListPixel(int16_t x, int16_t y, uint8_t colour)
+{
+    return LCD_ListAdd(LCD_ListOp_Pixel, colour, 0, x, y, 0, 0, nullptr);
+}
+
+/*!
+    @brief Record a line, see drawLine
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDListLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t colour)
+{
+    return LCD_ListAdd(LCD_ListOp_Line, colour, 0, x0, y0, x1, y1, nullptr);
+}
+
+/*!
+    @brief Record a rectangle outline, see drawRect
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDListRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour)
+{
+    return LCD_ListAdd(LCD_ListOp_Rect, colour, 0, x, y, w, h, nullptr);
+}
+
+/*!
+    @brief Record a filled rectangle, see fillRect
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDListFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour)
+{
+    return LCD_ListAdd(LCD_ListOp_FillRect, colour, 0, x, y, w, h, nullptr);
+}
+
+/*!
+    @brief Record a circle outline, see drawCircle
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDListCircle(int16_t x, int16_t y, int16_t r, uint8_t colour)
+{
+    return LCD_ListAdd(LCD_ListOp_Circle, colour, 0, x, y, r, 0, nullptr);
+}
+
+/*!
+    @brief Record a filled circle, see fillCircle
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDListFillCircle(int16_t x, int16_t y, int16_t r, uint8_t colour)
+{
+    return LCD_ListAdd(LCD_ListOp_FillCircle, colour, 0, x, y, r, 0, nullptr);
+}
+
+/*!
+    @brief Record a string in the current font, see drawText
+    @param text must stay valid until LCDupdateStrip
+    @param size text size, 0 for the number fonts (UC1609Font_Bignum and up)
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDListText(int16_t x, int16_t y, const char *text, uint8_t colour, uint8_t bg, uint8_t size)
+{
+    if (text == nullptr)
+    {
+        return LCD_CharArrayNullptr;
+    }
+    return LCD_ListAdd(LCD_ListOp_Text, colour, bg, x, y, size, getFontNum(), text);
+}
+
+/*!
+    @brief Record a bitmap, see drawBitmap
+    @param bitmap must stay valid until LCDupdateStrip
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDListBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint8_t colour, uint8_t bg)
+{
+    if (bitmap == nullptr)
+    {
+        return LCD_BitmapNullptr;
+    }
+    return LCD_ListAdd(LCD_ListOp_Bitmap, colour, bg, x, y, w, h, bitmap);
+}
+
+/*!
+    @brief Append one item to the display list
+    @return LCD_ListFull if the list has no room, LCD_Success otherwise
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCD_ListAdd(uint8_t op, uint8_t colour, uint8_t bg, int16_t a, int16_t b, int16_t c, int16_t d, const void *data)
+{
+    if (_listLength >= _listSize)
+    {
+        return LCD_ListFull;
+    }
+    LCD_ListItem_t &item = _list[_listLength++];
+    item.op = op;
+    item.color = colour;
+    item.bg = bg;
+    item.reserved = 0;
+    item.a = a;
+    item.b = b;
+    item.c = c;
+    item.d = d;
+    item.data = data;
+    return LCD_Success;
+}
+
+/*!
+    @brief Render the display list page by page through the strip and send each page
+    @return LCD_BusUnsupported before LCDStripBegin, LCD_BusBusy while
+    LCDbeginAsync is still sending the power-on sequence, LCD_Success otherwise
+    @note The icon row is sent from its own buffer when it changed. ActiveBuffer
+    is not used, a later LCDupdate sends a full frame.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDupdateStrip()
+{
+    if (_strip == nullptr)
+    {
+        return LCD_BusUnsupported;
+    }
+    if (!LCD_InitReady())
+    {
+        return LCD_BusBusy;
+    }
+    // 等待未完成的异步刷新
+    while (_asyncBusy)
+    {
+    }
+    _elidedBytes = 0;
+    _updateBytes = 0;
+    for (uint8_t page = 0; page < (_heightScreen / 8); page++)
+    {
+        memset(_strip, 0x00, _widthScreen);
+        LCD_ListReplay(page);
+        LCD_SetPageColumn(page, 0);
+        ST7565_send_data_burst(_strip, _widthScreen);
+        _updateBytes += _widthScreen;
+    }
+    if (_iconDirtyMin <= _iconDirtyMax)
+    {
+        // 图标行（第 8 页）
+        LCD_SetPageColumn(_heightScreen / 8, _iconDirtyMin);
+        ST7565_send_data_burst(&_InactiveBuffer[_iconDirtyMin], _iconDirtyMax - _iconDirtyMin + 1);
+        _updateBytes += _iconDirtyMax - _iconDirtyMin + 1;
+    }
+
+    // 玻璃内容不再对应 ActiveBuffer，图标行已发送
+    LCDinvalidateAll();
+    _iconDirtyMin = 0xFF;
+    _iconDirtyMax = 0;
+    return LCD_Success;
+}
+
+/*!
+    @brief Replay the display list into the strip of one page
+    @param page controller page the strip holds
+    @note Items outside the page are skipped, filled rectangles are clipped to
+    the page band, everything else is clipped per pixel by drawPixel.
+ */
+void ST7565_Parallel::LCD_ListReplay(uint8_t page)
+{
+    // 当前页在绘图坐标中的条带，随旋转方向变化
+    LCD_rotate_e rotation = getRotation();
+    bool bandOnX = (rotation == 1 || rotation == 3);
+    int16_t bandFrom = (rotation == 0 || rotation == 1) ? page * 8 : HEIGHT - page * 8 - 8;
+    int16_t bandTo = bandFrom + 8;
+
+    _stripPage = page;
+    _stripReplay = true;
+    LCD_Font_Type_e font = getFontNum();
+    for (uint16_t i = 0; i < _listLength; i++)
+    {
+        const LCD_ListItem_t &item = _list[i];
+        // 包围盒与条带不相交的项跳过
+        int16_t from, to;
+        switch (item.op)
+        {
+        case LCD_ListOp_Pixel:
+            from = bandOnX ? item.a : item.b;
+            to = from + 1;
+            break;
+        case LCD_ListOp_Line:
+            from = bandOnX ? ((item.a < item.c) ? item.a : item.c) : ((item.b < item.d) ? item.b : item.d);
+            to = (bandOnX ? ((item.a > item.c) ? item.a : item.c) : ((item.b > item.d) ? item.b : item.d)) + 1;
+            break;
+        case LCD_ListOp_Circle:
+        case LCD_ListOp_FillCircle:
+            from = (bandOnX ? item.a : item.b) - item.c;
+            to = (bandOnX ? item.a : item.b) + item.c + 1;
+            break;
+        case LCD_ListOp_Text:
+            from = bandFrom;
+            to = bandTo;
+            break;
+        default:
+            from = bandOnX ? item.a : item.b;
+            to = from + (bandOnX ? item.c : item.d);
+            break;
+        }
+        // 滚动后页与绘图坐标的对应关系按环形偏移，不做剔除
+        if (_scrollLine == 0 && (to <= bandFrom || from >= bandTo))
+        {
+            continue;
+        }
+
+        switch (item.op)
+        {
+        case LCD_ListOp_Pixel:
+            drawPixel(item.a, item.b, item.color);
+            break;
+        case LCD_ListOp_Line:
+            drawLine(item.a, item.b, item.c, item.d, item.color);
+            break;
+        case LCD_ListOp_Rect:
+            drawRect(item.a, item.b, item.c, item.d, item.color);
+            break;
+        case LCD_ListOp_FillRect:
+            if (_scrollLine != 0)
+            {
+                fillRect(item.a, item.b, item.c, item.d, item.color);
+                break;
+            }
+            // 只填充落在条带内的部分
+            if (from < bandFrom)
+            {
+                from = bandFrom;
+            }
+            if (to > bandTo)
+            {
+                to = bandTo;
+            }
+            if (bandOnX)
+            {
+                fillRect(from, item.b, to - from, item.d, item.color);
+            }
+            else
+            {
+                fillRect(item.a, from, item.c, to - from, item.color);
+            }
+            break;
+        case LCD_ListOp_Circle:
+            drawCircle(item.a, item.b, item.c, item.color);
+            break;
+        case LCD_ListOp_FillCircle:
+            fillCircle(item.a, item.b, item.c, item.color);
+            break;
+        case LCD_ListOp_Text:
+            setFontNum((LCD_Font_Type_e)item.d);
+            if (item.c == 0)
+            {
+                drawText(item.a, item.b, (char *)item.data, item.color, item.bg);
+            }
+            else
+            {
+                drawText(item.a, item.b, (char *)item.data, item.color, item.bg, item.c);
+            }
+            break;
+        case LCD_ListOp_Bitmap:
+            drawBitmap(item.a, item.b, (const uint8_t *)item.data, item.c, item.d, item.color, item.bg);
+            break;
+        }
+    }
+    if (getFontNum() != font)
+    {
+        setFontNum(font);
+    }
+    _stripReplay = false;
+}
+
+/*!
+    @brief Start writing the active buffer and the icon row to the screen
+    in the background, one DMA burst per changed span of a page
+    @param callback optional, called from the DMA interrupt when the frame is out
+    @return LCD_BusBusy if a frame or the power-on sequence is still going out,
+    LCD_BusUnsupported if the bus backend has no DMA path, LCD_Success otherwise
+    @note The buffers must not be changed until isBusy() returns false.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDupdateAsync(LCD_UpdateCallback_t callback)
+{
+    if (!_bus->canStartAsync())
+    {
+        return LCD_BusUnsupported;
+    }
+    if (_asyncBusy)
+    {
+        return LCD_BusBusy;
+    }
+    // 第一帧阻塞发送，随后的异步帧只剩之后画的内容
+    if (!LCD_InitReady())
+    {
+        return LCD_BusBusy;
+    }
+    _itActive = false;
+    LCD_AsyncStart(callback);
+    LCD_AsyncStartPage();
+    return LCD_Success;
+}
+
+/*!
+    @brief Start writing the active buffer and the icon row to the screen
+    in small slices from a periodic interrupt, for pin maps DMA cannot serve
+    @param bytesPerTick bus bytes (address commands included) per LCDrefreshTick,
+    bounds the interrupt latency the refresh adds
+    @param callback optional, called from the last tick of the frame
+    @return LCD_BusBusy if a frame or the power-on sequence is still going out,
+    LCD_Success otherwise
+    @note LCDrefreshTick must be called periodically, see LCDrefreshTimerBegin.
+    The bus must not be used from the main loop until the frame is out.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDupdateIT(uint16_t bytesPerTick, LCD_UpdateCallback_t callback)
+{
+    if (_asyncBusy || !LCD_InitReady())
+    {
+        return LCD_BusBusy;
+    }
+    _itBytesPerTick = (bytesPerTick == 0) ? 1 : bytesPerTick;
+    _itCommand = 0;
+    _itSent = 0;
+    LCD_AsyncStart(callback);
+    if (!LCD_AsyncNextRow())
+    {
+        LCD_AsyncFinish();
+        return LCD_Success;
+    }
+    _itPreambleLen = LCD_AddressCommands(_asyncCur.page, _asyncCur.column, _itPreamble);
+    _itActive = true;
+    return LCD_Success;
+}
+
+/*!
+    @brief Set up a timer update interrupt that calls into LCDrefreshTick
+    @param timer TIM1 to TIM4
+    @param timerIRQn the update interrupt of that timer
+    @param tickHz tick rate
+    @return LCD_BusUnsupported for other timers or rates, LCD_Success otherwise
+    @note The timer IRQ handler must call LCDrefreshTick, which clears the flag.
+ */
+LCD_Return_Codes_e ST7565_Parallel::LCDrefreshTimerBegin(TIM_TypeDef *timer, IRQn_Type timerIRQn, uint32_t tickHz)
+{
+    uint32_t clock;
+    if (timer == TIM1)
+    {
+        __HAL_RCC_TIM1_CLK_ENABLE();
+        // APB 分频不为 1 时定时器时钟加倍
+        clock = HAL_RCC_GetPCLK2Freq();
+        clock *= ((RCC->CFGR & RCC_CFGR_PPRE2) == RCC_CFGR_PPRE2_DIV1) ? 1 : 2;
+    }
+    else
+    {
+        if (timer == TIM2)
+        {
+            __HAL_RCC_TIM2_CLK_ENABLE();
+        }
+        else if (timer == TIM3)
+        {
+            __HAL_RCC_TIM3_CLK_ENABLE();
+        }
+        else if (timer == TIM4)
+        {
+            __HAL_RCC_TIM4_CLK_ENABLE();
+        }
+        else
+        {
+            return LCD_BusUnsupported;
+        }
+        clock = HAL_RCC_GetPCLK1Freq();
+        clock *= ((RCC->CFGR & RCC_CFGR_PPRE1) == RCC_CFGR_PPRE1_DIV1) ? 1 : 2;
+    }
+    if (tickHz == 0 || tickHz > clock)
+    {
+        return LCD_BusUnsupported;
+    }
+
+    // 预分频到 1MHz（tickHz 较高时不分频）
+    uint32_t prescaler = (tickHz <= 1000000U) ? clock / 1000000U : 1;
+    uint32_t reload = clock / prescaler / tickHz;
+    if (reload == 0 || reload > 0x10000U)
+    {
+        return LCD_BusUnsupported;
+    }
+    timer->CR1 = 0;
+    timer->PSC = prescaler - 1;
+    timer->ARR = reload - 1;
+    timer->EGR = TIM_EGR_UG;
+    timer->SR = 0;
+    timer->DIER = TIM_DIER_UIE;
+    timer->CR1 = TIM_CR1_CEN;
+    _itTimer = timer;
+
+    HAL_NVIC_SetPriority(timerIRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(timerIRQn);
+    return LCD_Success;
+}
+
+/*!
+    @brief Emit the next slice of an LCDupdateIT frame, at most bytesPerTick bus bytes
+    @note Call from a periodic interrupt, returns at once when no frame is running.
+ */
+void ST7565_Parallel::LCDrefreshTick()
+{
+    if (_itTimer != nullptr)
+    {
+        _itTimer->SR = ~(uint32_t)TIM_SR_UIF;
+    }
+    if (!_itActive)
+    {
+        return;
+    }
+
+    uint32_t start = dwt_cycles();
+    uint16_t budget = _itBytesPerTick;
+    while (budget > 0)
+    {
+        if (_itCommand < _itPreambleLen)
+        {
+            // 先发页地址和列地址（控制器已处于该地址的字节已省略）
+            uint8_t n = _itPreambleLen - _itCommand;
+            if (n > budget)
+            {
+                n = budget;
+            }
+            _bus->sendCommands(&_itPreamble[_itCommand], n);
+            _itCommand += n;
+            budget -= n;
+            continue;
+        }
+
+        uint16_t n = _asyncCur.len - _itSent;
+        if (n > budget)
+        {
+            n = budget;
+        }
+        ST7565_send_data_burst(_asyncCur.data + _itSent, n);
+        _itSent += n;
+        budget -= n;
+        if (_itSent == _asyncCur.len)
+        {
+            _itCommand = 0;
+            _itSent = 0;
+            if (!LCD_AsyncNextRow())
+            {
+                _itActive = false;
+                LCD_AsyncFinish();
+                break;
+            }
+            _itPreambleLen = LCD_AddressCommands(_asyncCur.page, _asyncCur.column, _itPreamble);
+        }
+    }
+
+    uint32_t cycles = dwt_cycles() - start;
+    if (cycles > _itMaxTickCycles)
+    {
+        _itMaxTickCycles = cycles;
+    }
+}
+
+/*!
+    @brief Getter for the longest LCDrefreshTick so far
+    @return CPU cycles, the worst case interrupt latency the refresh adds
+ */
+uint32_t ST7565_Parallel::LCDrefreshTickMaxCycles()
+{
+    return _itMaxTickCycles;
+}
+
+/*!
+    @brief Check whether an asynchronous update is still running
+    @return true while the frame is going out
+ */
+bool ST7565_Parallel::isBusy()
+{
+    return _asyncBusy;
+}
+
+/*!
+    @brief Update complete flag for the main loop
+    @return true once after each asynchronous frame has gone out
+ */
+bool ST7565_Parallel::LCDupdateComplete()
+{
+    if (!_updateComplete)
+    {
+        return false;
+    }
+    _updateComplete = false;
+    return true;
+}
+
+/*!
+    @brief DMA transfer complete handler, advances to the next page
+    @note Call from the IRQ handler of the DMA channel used by the bus backend.
+ */
+void ST7565_Parallel::LCD_DMA_IRQHandler()
+{
+    if (!_bus->asyncComplete())
+    {
+        return;
+    }
+    LCD_AsyncStartPage();
+}
+
+/*!
+    @brief Reset the row walk shared by all update paths
+ */
+void ST7565_Parallel::LCD_FrameStart()
+{
+    // 双缓冲时在 LCDswap 中转置，这里发送的是前台缓冲区
+    if (_frontScreen == nullptr)
+    {
+        LCDTransposeFlush();
+    }
+    ST7565_Parallel_Screen *screen = this->ActiveBuffer;
+    // 换了屏幕对象或偏移后，玻璃上的内容与缓冲区不再对应
+    if (screen != _dirtyScreen || screen->xoffset != _dirtyXoffset || screen->yoffset != _dirtyYoffset)
+    {
+        LCDinvalidateAll();
+        _dirtyScreen = screen;
+        _dirtyXoffset = screen->xoffset;
+        _dirtyYoffset = screen->yoffset;
+    }
+    _elidedBytes = 0;
+    _updateBytes = 0;
+    _diffSavedBytes = 0;
+    _diffChunks = 0;
+    _diffChunkHits = 0;
+    _asyncRow = 0;
+    _asyncSpan.from = 0;
+    _asyncSpan.to = 0;
+}
+
+/*!
+    @brief Reset the row walk of an asynchronous update
+    @param callback called when the frame is out
+ */
+void ST7565_Parallel::LCD_AsyncStart(LCD_UpdateCallback_t callback)
+{
+    _asyncBusy = true;
+    _updateComplete = false;
+    _asyncCallback = callback;
+    LCD_FrameStart();
+}
+
+/*!
+    @brief Advance _asyncCur to the next span to send, the icon row comes last
+    @return false when the frame is complete
+ */
+bool ST7565_Parallel::LCD_AsyncNextRow()
+{
+    for (;;)
+    {
+        if (_asyncSpan.from >= _asyncSpan.to)
+        {
+            if (!LCD_DirtyRowNext())
+            {
+                // 整帧发出后影子缓冲区（或块哈希）与玻璃一致，局部刷新不算
+                if (_regionCount == 0)
+                {
+                    _diffValid = (_diffMode != LCD_Diff_Off);
+                }
+                return false;
+            }
+            continue;
+        }
+        if (LCD_DiffRun())
+        {
+            _updateBytes += _asyncCur.len;
+            return true;
+        }
+    }
+}
+
+/*!
+    @brief Load the dirty span of the next visible row into _asyncSpan
+    @return false after the icon row
+    @note The dirty range of a row is cleared once it has been loaded. During
+    LCDupdateRegions the spans come from the rectangles instead, one call per
+    coalesced span, and the icon row is left out.
+ */
+bool ST7565_Parallel::LCD_DirtyRowNext()
+{
+    ST7565_Parallel_Screen *screen = this->ActiveBuffer;
+    uint8_t rows = screen->height / 8;
+    int16_t first = (screen->xoffset < 0) ? -screen->xoffset : 0;
+    int16_t last = (screen->xoffset + screen->width > _widthScreen) ? _widthScreen - screen->xoffset : screen->width;
+
+    while (_asyncRow < rows)
+    {
+        int16_t y = screen->yoffset + _asyncRow * 8;
+        int16_t from = first;
+        int16_t to = last;
+        if (_regionCount > 0)
+        {
+            if (y < 0 || y >= _heightScreen || !LCD_RegionSpanNext(_asyncRow, &from, &to))
+            {
+                _asyncRow++;
+                _regionColumn = 0;
+                continue;
+            }
+        }
+        uint8_t row = (_regionCount > 0) ? _asyncRow : _asyncRow++;
+        if (_regionCount > 0)
+        {
+            if (_diffHash != nullptr)
+            {
+                // 块哈希模式按整块发送，保证块内玻璃内容与哈希一致
+                int16_t chunkFrom = (screen->xoffset + from) / LCD_CHUNK_BYTES * LCD_CHUNK_BYTES - screen->xoffset;
+                int16_t chunkTo = (screen->xoffset + to + LCD_CHUNK_BYTES - 1) / LCD_CHUNK_BYTES * LCD_CHUNK_BYTES - screen->xoffset;
+                from = (chunkFrom < first) ? first : chunkFrom;
+                to = (chunkTo > last) ? last : chunkTo;
+                if (to > _regionColumn)
+                {
+                    _regionColumn = to;
+                }
+            }
+            if (row < LCD_DIRTY_ROWS)
+            {
+                LCD_DirtyTrim(row, from, to);
+            }
+        }
+        else if (row < LCD_DIRTY_ROWS)
+        {
+            // 可见列与脏列范围取交集，取出后清除
+            if (_dirtyMin[row] > from)
+            {
+                from = _dirtyMin[row];
+            }
+            if (_dirtyMax[row] + 1 < to)
+            {
+                to = _dirtyMax[row] + 1;
+            }
+            _dirtyMin[row] = 0xFF;
+            _dirtyMax[row] = 0;
+        }
+        if (y < 0 || y >= _heightScreen || from >= to)
+        {
+            continue;
+        }
+        // 双缓冲时从前台缓冲区发送
+        const uint8_t *source = (screen == _frontScreen) ? _frontBuffer : screen->screenBuffer;
+        _asyncSpan.data = &source[screen->width * row];
+        _asyncSpan.from = from;
+        _asyncSpan.to = to;
+        _asyncSpan.visibleFrom = first;
+        _asyncSpan.visibleTo = last;
+        _asyncSpan.page = y / 8;
+        _asyncSpan.column = screen->xoffset;
+        return true;
+    }
+    if (_asyncRow == rows)
+    {
+        // 图标行（第 8 页）
+        _asyncRow++;
+        if (_regionCount == 0 && _iconDirtyMin <= _iconDirtyMax)
+        {
+            _asyncSpan.data = _InactiveBuffer;
+            _asyncSpan.from = _iconDirtyMin;
+            _asyncSpan.to = _iconDirtyMax + 1;
+            _asyncSpan.visibleFrom = 0;
+            _asyncSpan.visibleTo = _iconwidthScreen;
+            _asyncSpan.page = _heightScreen / 8;
+            _asyncSpan.column = 0;
+            _iconDirtyMin = 0xFF;
+            _iconDirtyMax = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+    @brief Next span of a buffer row covered by the LCDupdateRegions rectangles
+    @param row buffer row
+    @param from receives the first buffer column, holds the first visible column on entry
+    @param to receives the end column, exclusive, holds the visible end on entry
+    @return false when the row has no more covered columns
+    @note Rectangles overlapping, touching or closer than the merge gap are
+    joined into one span, _regionColumn walks along the row.
+ */
+bool ST7565_Parallel::LCD_RegionSpanNext(uint8_t row, int16_t *from, int16_t *to)
+{
+    int16_t first = (*from > _regionColumn) ? *from : _regionColumn;
+    int16_t last = *to;
+    int16_t start = last;
+    int16_t end = last;
+    int16_t x0, x1, row0, row1;
+
+    // 最左边的一段
+    for (uint8_t i = 0; i < _regionCount; i++)
+    {
+        LCD_RegionBounds(_regionRects[i], &x0, &x1, &row0, &row1);
+        if (!LCD_RegionRowHit(row, row0, row1) || x1 <= first || x0 >= last)
+        {
+            continue;
+        }
+        if (x0 < first)
+        {
+            x0 = first;
+        }
+        if (x0 < start)
+        {
+            start = x0;
+            end = x1;
+        }
+    }
+    if (start >= last)
+    {
+        return false;
+    }
+
+    // 并入与该段重叠或间隔不超过合并间隔的矩形，直到不再增长
+    bool grown = true;
+    while (grown)
+    {
+        grown = false;
+        for (uint8_t i = 0; i < _regionCount; i++)
+        {
+            LCD_RegionBounds(_regionRects[i], &x0, &x1, &row0, &row1);
+            if (!LCD_RegionRowHit(row, row0, row1) || x0 > end + _diffMergeGap || x1 <= end)
+            {
+                continue;
+            }
+            end = x1;
+            grown = true;
+        }
+    }
+    if (end > last)
+    {
+        end = last;
+    }
+    *from = start;
+    *to = end;
+    _regionColumn = end;
+    return true;
+}
+
+/*!
+    @brief A rectangle in drawing coordinates as buffer columns and rows
+    @param rect the rectangle, rotated like drawPixel
+    @param x0 receives the first buffer column
+    @param x1 receives the end column, exclusive
+    @param row0 receives the first buffer row (page)
+    @param row1 receives the end row, exclusive
+ */
+void ST7565_Parallel::LCD_RegionBounds(const LCD_Rect_t &rect, int16_t *x0, int16_t *x1, int16_t *row0, int16_t *row1)
+{
+    int16_t y0, y1;
+    switch (getRotation())
+    {
+    case 1:
+        *x0 = WIDTH - rect.y - rect.h;
+        y0 = rect.x;
+        *x1 = *x0 + rect.h;
+        y1 = y0 + rect.w;
+        break;
+    case 2:
+        *x0 = WIDTH - rect.x - rect.w;
+        y0 = HEIGHT - rect.y - rect.h;
+        *x1 = *x0 + rect.w;
+        y1 = y0 + rect.h;
+        break;
+    case 3:
+        *x0 = rect.y;
+        y0 = HEIGHT - rect.x - rect.w;
+        *x1 = *x0 + rect.h;
+        y1 = y0 + rect.w;
+        break;
+    default:
+        *x0 = rect.x;
+        y0 = rect.y;
+        *x1 = *x0 + rect.w;
+        y1 = y0 + rect.h;
+        break;
+    }
+    // 纵向取整到页边界
+    if (y0 < 0)
+    {
+        y0 = 0;
+    }
+    if (y1 > HEIGHT)
+    {
+        y1 = HEIGHT;
+    }
+    // 滚动后按环形偏移，结束行可能超过最后一页
+    y0 += _scrollLine;
+    y1 += _scrollLine;
+    *row0 = y0 / 8;
+    *row1 = (y1 <= y0) ? *row0 : (y1 + 7) / 8;
+    if (*x0 < 0)
+    {
+        *x0 = 0;
+    }
+}
+
+/*!
+    @brief Remove sent columns from the dirty range of a row where the range allows it
+    @param row buffer row below LCD_DIRTY_ROWS
+    @param from first column sent
+    @param to end column sent, exclusive
+    @note The range only keeps its ends, a hole in the middle stays dirty.
+ */
+void ST7565_Parallel::LCD_DirtyTrim(uint8_t row, int16_t from, int16_t to)
+{
+    int16_t dirtyMin = _dirtyMin[row];
+    int16_t dirtyMax = _dirtyMax[row];
+    if (dirtyMin > dirtyMax)
+    {
+        return;
+    }
+    if (from <= dirtyMin && to > dirtyMax)
+    {
+        _dirtyMin[row] = 0xFF;
+        _dirtyMax[row] = 0;
+    }
+    else if (from <= dirtyMin && to > dirtyMin)
+    {
+        _dirtyMin[row] = to;
+    }
+    else if (from <= dirtyMax && to > dirtyMax)
+    {
+        _dirtyMax[row] = from - 1;
+    }
+}
+
+/*!
+    @brief Take the next changed run out of _asyncSpan into _asyncCur
+    @return false if the rest of the span matches the glass
+    @details Without change detection, or before the glass is known, the
+    whole span is one run. Changed runs separated by at most the merge gap
+    of unchanged bytes are sent as one, which is cheaper than a new column
+    address and burst.
+ */
+bool ST7565_Parallel::LCD_DiffRun()
+{
+    const uint8_t *data = _asyncSpan.data + _asyncSpan.from;
+    uint16_t n = _asyncSpan.to - _asyncSpan.from;
+    uint16_t start = 0;
+    uint16_t end = n;
+    uint16_t next = n;
+    bool changed = true;
+    if (_diffShadow != nullptr)
+    {
+        changed = LCD_DiffShadowRun(data, n, &start, &end);
+        next = end;
+    }
+    else if (_diffHash != nullptr)
+    {
+        changed = LCD_DiffHashRun(n, &start, &end, &next);
+    }
+    if (!changed)
+    {
+        _asyncSpan.from = _asyncSpan.to;
+        return false;
+    }
+
+    _asyncCur.data = data + start;
+    _asyncCur.len = end - start;
+    _asyncCur.page = _asyncSpan.page;
+    _asyncCur.column = _asyncSpan.column + _asyncSpan.from + start;
+    _asyncSpan.from += next;
+    return true;
+}
+
+/*!
+    @brief Find the next changed run by comparing with the shadow copy of the glass
+    @param data first byte of the span left
+    @param n bytes in the span
+    @param start receives the first byte of the run
+    @param end receives the end of the run, exclusive
+    @return false if the span matches the glass
+ */
+bool ST7565_Parallel::LCD_DiffShadowRun(const uint8_t *data, uint16_t n, uint16_t *start, uint16_t *end)
+{
+    uint8_t *glass = &_diffShadow[_asyncSpan.page * _widthScreen + _asyncSpan.column + _asyncSpan.from];
+    uint16_t i = 0;
+    if (_diffValid)
+    {
+        // 32 位比较跳过与玻璃相同的字节
+        uint32_t a, b;
+        while (i < n)
+        {
+            if (n - i >= 4)
+            {
+                memcpy(&a, data + i, 4);
+                memcpy(&b, glass + i, 4);
+                if (a == b)
+                {
+                    i += 4;
+                    continue;
+                }
+            }
+            if (data[i] != glass[i])
+            {
+                break;
+            }
+            i++;
+        }
+        _diffSavedBytes += i;
+        if (i == n)
+        {
+            return false;
+        }
+        // 相同字节不超过合并间隔时并入同一段
+        *end = i + 1;
+        for (uint16_t k = *end; k < n && (k - *end) <= _diffMergeGap; k++)
+        {
+            if (data[k] != glass[k])
+            {
+                *end = k + 1;
+            }
+        }
+    }
+    *start = i;
+    memcpy(glass + *start, data + *start, *end - *start);
+    return true;
+}
+
+/*!
+    @brief Find the next changed run by comparing chunk hashes
+    @param n bytes in the span left
+    @param start receives the first byte of the run
+    @param end receives the end of the run, exclusive
+    @param next receives where the next search starts
+    @return false if every chunk of the span hashes as before
+    @note A chunk is LCD_CHUNK_BYTES controller columns, its hash covers the
+    visible buffer bytes in it. Only the dirty part of a changed chunk is sent,
+    the rest of it already matches the glass.
+ */
+bool ST7565_Parallel::LCD_DiffHashRun(uint16_t n, uint16_t *start, uint16_t *end, uint16_t *next)
+{
+    // 块边界按控制器列号计算
+    int16_t origin = _asyncSpan.column + _asyncSpan.from;
+    uint16_t i = 0;
+    uint16_t chunkEnd;
+    bool found = false;
+    while (i < n && !found)
+    {
+        chunkEnd = ((origin + i) / LCD_CHUNK_BYTES + 1) * LCD_CHUNK_BYTES - origin;
+        if (chunkEnd > n)
+        {
+            chunkEnd = n;
+        }
+        found = LCD_ChunkUpdate(origin + i);
+        if (!found)
+        {
+            _diffSavedBytes += chunkEnd - i;
+            i = chunkEnd;
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+    *start = i;
+    *end = chunkEnd;
+    *next = chunkEnd;
+
+    // 未变化的块不长于合并间隔时并入同一段
+    i = chunkEnd;
+    while (i < n)
+    {
+        chunkEnd = ((origin + i) / LCD_CHUNK_BYTES + 1) * LCD_CHUNK_BYTES - origin;
+        if (chunkEnd > n)
+        {
+            chunkEnd = n;
+        }
+        if (LCD_ChunkUpdate(origin + i))
+        {
+            *end = chunkEnd;
+        }
+        else if (chunkEnd - *end > _diffMergeGap)
+        {
+            // 该块不发送，下次从块尾继续
+            _diffSavedBytes += chunkEnd - *end;
+            *next = chunkEnd;
+            return true;
+        }
+        i = chunkEnd;
+    }
+    // 行尾未变化的块不发送
+    _diffSavedBytes += n - *end;
+    *next = n;
+    return true;
+}
+
+/*!
+    @brief Hash the chunk holding a controller column and compare with the last sent hash
+    @param column controller column 0-131
+    @return true if the chunk changed or the glass is not known, the new hash is then kept
+ */
+bool ST7565_Parallel::LCD_ChunkUpdate(int16_t column)
+{
+    // 块内只对属于当前行可见部分的字节计算哈希
+    int16_t chunk = column / LCD_CHUNK_BYTES;
+    int16_t from = chunk * LCD_CHUNK_BYTES;
+    int16_t to = from + LCD_CHUNK_BYTES;
+    int16_t visibleFrom = _asyncSpan.column + _asyncSpan.visibleFrom;
+    int16_t visibleTo = _asyncSpan.column + _asyncSpan.visibleTo;
+    if (from < visibleFrom)
+    {
+        from = visibleFrom;
+    }
+    if (to > visibleTo)
+    {
+        to = visibleTo;
+    }
+    uint32_t hash = LCD_ChunkHash(_asyncSpan.data + (from - _asyncSpan.column), to - from);
+    uint32_t *slot = &_diffHash[_asyncSpan.page * LCD_CHUNKS_PER_PAGE + chunk];
+    if (!_diffValid)
+    {
+        *slot = hash;
+        return true;
+    }
+    _diffChunks++;
+    if (*slot == hash)
+    {
+        _diffChunkHits++;
+        return false;
+    }
+    *slot = hash;
+    return true;
+}
+
+/*!
+    @brief CRC-32 of up to LCD_CHUNK_BYTES bytes, zero padded to whole words
+    @param data first byte
+    @param len number of bytes
+    @return the CRC, from the CRC peripheral or from software with LCD_CRC_SOFTWARE
+    @note The CRC peripheral is reset for every chunk, other users of it must
+    not run in between or from a higher priority interrupt.
+ */
+uint32_t ST7565_Parallel::LCD_ChunkHash(const uint8_t *data, uint8_t len)
+{
+    uint32_t word;
+#ifdef LCD_CRC_SOFTWARE
+    // 与 STM32 CRC 单元相同：多项式 0x04C11DB7，初值全 1，按 32 位字输入
+    uint32_t crc = 0xFFFFFFFFU;
+    for (uint8_t i = 0; i < len; i += 4)
+    {
+        word = 0;
+        memcpy(&word, data + i, (len - i < 4) ? len - i : 4);
+        crc ^= word;
+        for (uint8_t bit = 0; bit < 32; bit++)
+        {
+            crc = (crc & 0x80000000U) ? (crc << 1) ^ 0x04C11DB7U : (crc << 1);
+        }
+    }
+    return crc;
+#else
+    CRC->CR = CRC_CR_RESET;
+    for (uint8_t i = 0; i < len; i += 4)
+    {
+        word = 0;
+        memcpy(&word, data + i, (len - i < 4) ? len - i : 4);
+        CRC->DR = word;
+    }
+    return CRC->DR;
+#endif
+}
+
+/*!
+    @brief Send the address of the next visible page and start its DMA burst,
+    or finish the frame
+ */
+void ST7565_Parallel::LCD_AsyncStartPage()
+{
+    if (!LCD_AsyncNextRow())
+    {
+        LCD_AsyncFinish();
+        return;
+    }
+
+    LCD_SetPageColumn(_asyncCur.page, _asyncCur.column);
+    _bus->startDataAsync(_asyncCur.data, _asyncCur.len);
+    LCD_ShadowAdvance(_asyncCur.len);
+}
+
+/*!
+    @brief Mark the asynchronous frame as done and run the callback
+ */
+void ST7565_Parallel::LCD_AsyncFinish()
+{
+    _asyncBusy = false;
+    _updateComplete = true;
+    if (_asyncCallback != nullptr)
+    {
+        _asyncCallback();
+    }
+}
+
+/*!
+    @brief clears the buffer of the active screen pointed to by ActiveBuffer
+    @note Does NOT write to the screen
+ */
+void ST7565_Parallel::LCDclearBuffer()
+{
+    memset(this->ActiveBuffer->screenBuffer, 0x00, (this->ActiveBuffer->width * (this->ActiveBuffer->height / 8)));
+    if (_transposeBuffer != nullptr)
+    {
+        // 面板缓冲区已清空，竖屏缓冲区无需再转置
+        memset(_transposeBuffer, 0x00, WIDTH * (HEIGHT / 8));
+        memset(_transposeDirty, 0x00, sizeof(_transposeDirty));
+    }
+    if (_InactiveBuffer != nullptr)
+    {
+        memset(_InactiveBuffer, 0x00, _iconwidthScreen);
+    }
+    // 只标记绘图侧全部修改，玻璃内容仍已知
+    for (uint8_t row = 0; row < LCD_DIRTY_ROWS; row++)
+    {
+        _drawDirtyMin[row] = 0;
+        _drawDirtyMax[row] = 0xFF;
+    }
+    LCD_IconDirty(0, _iconwidthScreen - 1);
+}
+
+/*!
+    @brief Draw a data array to the screen
+    @param x offset 0-128
+    @param y offset 0-64
+    @param w width 0-28
+    @param h height 0-64
+    @param data pointer to the data array
+    @note Writes the whole array, LCDupdate sends only the changed columns instead.
+ */
+void ST7565_Parallel::LCDBuffer(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t *data)
+{
+    // 直接写屏，玻璃上的内容不再与缓冲区一致
+    LCDinvalidateAll();
+    uint8_t ty;
+    uint8_t column = (x < 0) ? 0 : x;
+    uint8_t page = (y < 0) ? 0 : y / 8;
+    // 每页只传输屏幕内可见的列
+    int16_t first = (x < 0) ? -x : 0;
+    int16_t last = (x + w > _widthScreen) ? _widthScreen - x : w;
+
+    for (ty = 0; ty < h; ty = ty + 8)
+    {
+        if (y + ty < 0 || y + ty >= _heightScreen)
+        {
+            continue;
+        }
+
+        LCD_SetPageColumn(page++, column);
+        if (first < last)
+        {
+            ST7565_send_data_burst(&data[(w * (ty / 8)) + first], last - first);
+        }
+    }
+}
+
+/*!
+    @brief Write icon row data directly to the screen, bypassing the icon row buffer
+    @param x first column, data[i] goes to column x + i
+    @param w number of bytes
+    @param data pointer to the data array
+    @note One address setup and one burst for the visible columns, always on
+    the icon row (page 8).
+ */
+void ST7565_Parallel::LCDBuffer_Icon(int16_t x, uint8_t w, uint8_t *data)
+{
+    // 直接写屏，玻璃上的内容不再与缓冲区一致
+    LCDinvalidateAll();
+    int16_t first = (x < 0) ? -x : 0;
+    int16_t last = (x + w > _iconwidthScreen) ? _iconwidthScreen - x : w;
+    if (first >= last)
+    {
+        return;
+    }
+    LCD_SetPageColumn(8, x + first);
+    ST7565_send_data_burst(&data[first], last - first);
+}
+
+/*!
+    @brief Fill a rectangle, overrides the graphics library
+    @param x left edge
+    @param y top edge
+    @param w width in pixels
+    @param h height in pixels
+    @param colour FOREGROUND, BACKGROUND or COLORINVERSE
+    @note Works on whole buffer bytes: the top and bottom pages get a partial
+    mask, the pages in between full byte stores, instead of one drawPixel
+    per pixel.
+ */
+void ST7565_Parallel::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour)
+{
+    if (w <= 0 || h <= 0 || (!_stripReplay && this->ActiveBuffer == nullptr))
+    {
+        return;
+    }
+    if (_transposeBuffer != nullptr)
+    {
+        LCD_TransposeFill(x, y, w, h, colour);
+        return;
+    }
+    // 转换到未旋转的缓冲区坐标
+    int16_t x0, y0, x1, y1;
+    switch (getRotation())
+    {
+    case 1:
+        x0 = WIDTH - y - h;
+        y0 = x;
+        x1 = x0 + h;
+        y1 = y0 + w;
+        break;
+    case 2:
+        x0 = WIDTH - x - w;
+        y0 = HEIGHT - y - h;
+        x1 = x0 + w;
+        y1 = y0 + h;
+        break;
+    case 3:
+        x0 = y;
+        y0 = HEIGHT - x - w;
+        x1 = x0 + h;
+        y1 = y0 + w;
+        break;
+    default:
+        x0 = x;
+        y0 = y;
+        x1 = x0 + w;
+        y1 = y0 + h;
+        break;
+    }
+    if (x0 < 0)
+    {
+        x0 = 0;
     }
-    if (x > _width || y > _height)
+    if (y0 < 0)
     {
-        return LCD_BitmapScreenBounds;
+        y0 = 0;
     }
-    if (w > _width || h > _height)
+    if (x1 > WIDTH)
     {
-        return LCD_BitmapLargerThanScreen;
+        x1 = WIDTH;
     }
-    if ((h % 8 != 0))
+    if (y1 > HEIGHT)
     {
-        return LCD_BitmapVerticalSize;
+        y1 = HEIGHT;
     }
-
-    // LCD_CS_LOW();
-
-    uint8_t tx, ty;
-    uint16_t offset = 0;
-    uint8_t column = (x < 0) ? 0 : x;
-    uint8_t page = (y < 0) ? 0 : y >> 3;
-
-    for (ty = 0; ty < h; ty = ty + 8)
+    if (x0 >= x1 || y0 >= y1)
     {
-        if (y + ty < 0 || y + ty >= _heightScreen)
-        {
-            continue;
-        }
-        // send_command(UC1609_SET_COLADD_LSB, (column & 0x0F));
-        // send_command(UC1609_SET_COLADD_MSB, (column & 0xF0) >> 4);
-        // send_command(UC1609_SET_PAGEADD, page++);
-        LCD_SetPage(page++);
-        LCD_SetColumn(column);
+        return;
+    }
 
-        for (tx = 0; tx < w; tx++)
-        {
-            if (x + tx < 0 || x + tx >= _widthScreen)
-            {
-                continue;
-            }
-            offset = (w * (ty >> 3)) + tx;
-            // send_data(pgm_read_byte(&data[offset]));
-            ST7565_send_data(pgm_read_byte(&data[offset]));
-        }
+    // 滚动后按环形偏移，跨过缓冲区末尾时分成两段
+    y0 += _scrollLine;
+    y1 += _scrollLine;
+    if (y0 >= LCD_SCROLL_LINES)
+    {
+        y0 -= LCD_SCROLL_LINES;
+        y1 -= LCD_SCROLL_LINES;
     }
-    // LCD_CS_HIGH();
-    return LCD_Success;
+    else if (y1 > LCD_SCROLL_LINES)
+    {
+        LCD_FillLines(x0, x1, 0, y1 - LCD_SCROLL_LINES, colour);
+        y1 = LCD_SCROLL_LINES;
+    }
+    LCD_FillLines(x0, x1, y0, y1, colour);
 }
 
 /*!
-    @brief updates the LCD i.e. writes the shared buffer to the active screen
-    pointed to by ActiveBuffer
+    @brief Vertical line, overrides the graphics library
+    @param x column
+    @param y top end
+    @param h length in pixels, nothing is drawn for h <= 0
+    @param colour FOREGROUND, BACKGROUND or COLORINVERSE
+    @note Clipped once, then one masked byte operation per page.
  */
-void ST7565_Parallel::LCDupdate()
+void ST7565_Parallel::drawFastVLine(int16_t x, int16_t y, int16_t h, uint8_t colour)
 {
-    LCDBuffer(this->ActiveBuffer->xoffset, this->ActiveBuffer->yoffset, this->ActiveBuffer->width, this->ActiveBuffer->height, this->ActiveBuffer->screenBuffer);
-    LCDBuffer_Icon(0, 0, _iconwidthScreen, _iconheightScreen, _InactiveBuffer);
+    ST7565_Parallel::fillRect(x, y, 1, h, colour);
 }
 
 /*!
-    @brief clears the buffer of the active screen pointed to by ActiveBuffer
-    @note Does NOT write to the screen
+    @brief Horizontal line, overrides the graphics library
+    @param x left end
+    @param y row
+    @param w length in pixels, nothing is drawn for w <= 0
+    @param colour FOREGROUND, BACKGROUND or COLORINVERSE
+    @note Clipped once, then the same bit mask applied along the columns.
  */
-void ST7565_Parallel::LCDclearBuffer()
+void ST7565_Parallel::drawFastHLine(int16_t x, int16_t y, int16_t w, uint8_t colour)
 {
-    memset(this->ActiveBuffer->screenBuffer, 0x00, (this->ActiveBuffer->width * (this->ActiveBuffer->height / 8)));
-    memset(_InactiveBuffer, 0x00, _bufferSize);
+    ST7565_Parallel::fillRect(x, y, w, 1, colour);
 }
 
 /*!
-    @brief Draw a data array to the screen
-    @param x offset 0-128
-    @param y offset 0-64
-    @param w width 0-28
-    @param h height 0-64
-    @param data pointer to the data array
-    @note Called by LCDupdate internally to write buffer to screen, can be called standalone as well
+    @brief Fill buffer lines y0 to y1 - 1 between columns x0 and x1 - 1
+    @param x0 first column
+    @param x1 end column, exclusive
+    @param y0 first buffer line
+    @param y1 end line, exclusive
+    @param colour FOREGROUND, BACKGROUND or COLORINVERSE
+    @note Writes the strip during a strip replay, the active buffer otherwise.
  */
-void ST7565_Parallel::LCDBuffer(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t *data)
+void ST7565_Parallel::LCD_FillLines(int16_t x0, int16_t x1, int16_t y0, int16_t y1, uint8_t colour)
 {
-    uint8_t tx, ty;
-    uint16_t offset = 0;
-    uint8_t column = (x < 0) ? 0 : x;
-    uint8_t page = (y < 0) ? 0 : y / 8;
-
-    for (ty = 0; ty < h; ty = ty + 8)
+    uint8_t stride = _stripReplay ? _widthScreen : this->ActiveBuffer->width;
+    if (x1 > stride)
     {
-        if (y + ty < 0 || y + ty >= _heightScreen)
+        x1 = stride;
+    }
+    if (x0 >= x1)
+    {
+        return;
+    }
+    uint8_t lastRow = (y1 - 1) >> 3;
+    for (uint8_t row = y0 >> 3; row <= lastRow; row++)
+    {
+        // 首页和末页只改动矩形覆盖的位
+        uint8_t mask = 0xFF;
+        if (row == (y0 >> 3))
         {
-            continue;
+            mask &= (uint8_t)(0xFF << (y0 & 7));
+        }
+        if (row == lastRow)
+        {
+            mask &= (uint8_t)(0xFF >> (7 - ((y1 - 1) & 7)));
         }
 
-        LCD_SetPage(page++);
-        LCD_SetColumn(column);
-
-        for (tx = 0; tx < w; tx++)
+        uint8_t *target;
+        if (_stripReplay)
         {
-            if (x + tx < 0 || x + tx >= _widthScreen)
+            if (row != _stripPage)
             {
                 continue;
             }
-            offset = (w * (ty / 8)) + tx;
-            ST7565_send_data(data[offset++]);
+            target = &_strip[x0];
+        }
+        else
+        {
+            if (row >= this->ActiveBuffer->height / 8)
+            {
+                break;
+            }
+            target = &this->ActiveBuffer->screenBuffer[stride * row + x0];
+            if (row < LCD_DIRTY_ROWS)
+            {
+                if (x0 < _drawDirtyMin[row])
+                {
+                    _drawDirtyMin[row] = x0;
+                }
+                if (x1 - 1 > _drawDirtyMax[row])
+                {
+                    _drawDirtyMax[row] = x1 - 1;
+                }
+            }
         }
-    }
-}
-
-void ST7565_Parallel::LCDBuffer_Icon(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t *data)
-{
-    uint8_t tx;
-    uint16_t offset = 0;
-    uint8_t column = (x < 0) ? 0 : x;
-    uint8_t page = 8; // 将 page 设置为 8
-    LCD_SetPage(page);
 
-    // 处理整个高度 h
-    for (tx = 0; tx < w; tx++)
-    {
-        LCD_SetColumn(tx);
-        if (x + tx < 0 || x + tx >= _iconwidthScreen)
+        int16_t len = x1 - x0;
+        switch (colour)
         {
-            continue;
+        case FOREGROUND:
+            if (mask == 0xFF)
+            {
+                memset(target, 0xFF, len);
+                break;
+            }
+            for (int16_t i = 0; i < len; i++)
+            {
+                target[i] |= mask;
+            }
+            break;
+        case BACKGROUND:
+            if (mask == 0xFF)
+            {
+                memset(target, 0x00, len);
+                break;
+            }
+            for (int16_t i = 0; i < len; i++)
+            {
+                target[i] &= ~mask;
+            }
+            break;
+        case COLORINVERSE:
+            for (int16_t i = 0; i < len; i++)
+            {
+                target[i] ^= mask;
+            }
+            break;
         }
-        offset = tx; // 这里的 0 是因为我们不再使用 ty
-        ST7565_send_data(data[offset]);
     }
 }
 
@@ -620,45 +2948,104 @@ void ST7565_Parallel::LCDBuffer_Icon(int16_t x, int16_t y, uint8_t w, uint8_t h,
     @param x x co-ord of pixel
     @param y y co-ord of pixel
     @param colour colour of pixel
+    @note Calls the writer setRotation picked, no rotation switch per pixel.
  */
 void ST7565_Parallel::drawPixel(int16_t x, int16_t y, uint8_t colour)
 {
-    if ((x < 0) || (x >= _width) || (y < 0) || (y >= _height))
-        return;
+    (this->*_pixelWriter)(x, y, colour);
+}
 
-    int16_t temp;
-    uint8_t RotateMode = getRotation();
-    switch (RotateMode)
+/*!
+    @brief Sets the rotation and picks the pixel writer compiled for it
+    @param rotation LCD_Degrees_0 to LCD_Degrees_270
+    @note Ends a transposed rotation, see LCDTransposeSet.
+ */
+void ST7565_Parallel::setRotation(LCD_rotate_e rotation)
+{
+    // 回到逐像素旋转，LCDTransposeSet 之后再切换到转置写入
+    _transposeBuffer = nullptr;
+    ST7565_graphics::setRotation(rotation);
+    switch (rotation)
     {
-    case 1:
-        temp = x;
-        x = WIDTH - 1 - y;
-        y = temp;
+    case LCD_Degrees_90:
+        _pixelWriter = &ST7565_Parallel::LCD_PixelRotated<LCD_Degrees_90>;
         break;
-    case 2:
-        x = WIDTH - 1 - x;
-        y = HEIGHT - 1 - y;
+    case LCD_Degrees_180:
+        _pixelWriter = &ST7565_Parallel::LCD_PixelRotated<LCD_Degrees_180>;
         break;
-    case 3:
-        temp = x;
-        x = y;
-        y = HEIGHT - 1 - temp;
+    case LCD_Degrees_270:
+        _pixelWriter = &ST7565_Parallel::LCD_PixelRotated<LCD_Degrees_270>;
+        break;
+    default:
+        _pixelWriter = &ST7565_Parallel::LCD_PixelRotated<LCD_Degrees_0>;
         break;
     }
+}
+
+/*!
+    @brief drawPixel for one rotation, the coordinate transform is fixed at compile time
+    @param x x co-ord of pixel
+    @param y y co-ord of pixel
+    @param colour colour of pixel
+ */
+template <uint8_t Rotation>
+void ST7565_Parallel::LCD_PixelRotated(int16_t x, int16_t y, uint8_t colour)
+{
+    if ((x < 0) || (x >= _width) || (y < 0) || (y >= _height))
+        return;
 
-    uint16_t offset = (this->ActiveBuffer->width * (y / 8)) + x;
-    switch (colour)
+    // 换算到缓冲区坐标，Rotation 为常量，只保留一个分支
+    int16_t bx = x;
+    int16_t by = y;
+    if (Rotation == LCD_Degrees_90)
     {
-    case FOREGROUND:
-        this->ActiveBuffer->screenBuffer[offset] |= (1 << (y & 7));
-        break;
-    case BACKGROUND:
-        this->ActiveBuffer->screenBuffer[offset] &= ~(1 << (y & 7));
-        break;
-    case COLORINVERSE:
-        this->ActiveBuffer->screenBuffer[offset] ^= (1 << (y & 7));
-        break;
+        bx = WIDTH - 1 - y;
+        by = x;
+    }
+    else if (Rotation == LCD_Degrees_180)
+    {
+        bx = WIDTH - 1 - x;
+        by = HEIGHT - 1 - y;
+    }
+    else if (Rotation == LCD_Degrees_270)
+    {
+        bx = y;
+        by = HEIGHT - 1 - x;
+    }
+
+    // 缓冲区按环形使用，原点随硬件滚动移动
+    if (_scrollLine != 0)
+    {
+        by = (by + _scrollLine) & (LCD_SCROLL_LINES - 1);
+    }
+
+    // 边界检查后坐标非负，移位代替除法
+    uint8_t row = (uint16_t)by >> 3;
+    uint8_t bit = by & 7;
+    if (_stripReplay)
+    {
+        // 条带模式只画落在当前页内的像素
+        if (row != _stripPage)
+        {
+            return;
+        }
+        LCD_PixelWrite(&_strip[bx], bit, colour);
+        return;
+    }
+
+    // 扩展该行的脏列范围
+    if (row < LCD_DIRTY_ROWS)
+    {
+        if (bx < _drawDirtyMin[row])
+        {
+            _drawDirtyMin[row] = bx;
+        }
+        if (bx > _drawDirtyMax[row])
+        {
+            _drawDirtyMax[row] = bx;
+        }
     }
+    LCD_PixelWrite(&this->ActiveBuffer->screenBuffer[this->ActiveBuffer->width * row + bx], bit, colour);
 }
 
 /*!
@@ -693,6 +3080,44 @@ uint8_t ST7565_Parallel::LCDGetAddressCtrl()
     return _AddressCtrl;
 }
 
+/*!
+    @brief Getter for the bus backend
+    @return the transport given to (or created by) the constructor
+ */
+ST7565_Bus *ST7565_Parallel::LCDBusGet()
+{
+    return _bus;
+}
+
+/*!
+    @brief Select the 8080 write timing profile of a controller variant
+    @param controller LCD_Controller_e enum
+ */
+void ST7565_Parallel::LCDBusTimingSet(LCD_Controller_e controller)
+{
+    LCDBusTimingSet(*LCD_BusTimingGet(controller));
+}
+
+/*!
+    @brief Set a custom 8080 write timing profile
+    @param timing tAS, tAH, tCYC and WR low pulse width in ns
+    @note Converted to CPU cycles at the current SystemCoreClock, and again in LCDbegin.
+ */
+void ST7565_Parallel::LCDBusTimingSet(const LCD_BusTiming_t &timing)
+{
+    _busTiming = timing;
+    _bus->setTiming(_busTiming);
+}
+
+/*!
+    @brief Getter for the 8080 write timing profile
+    @return the profile in ns
+ */
+LCD_BusTiming_t ST7565_Parallel::LCDBusTimingGet()
+{
+    return _busTiming;
+}
+
 /*!
     @brief Library version number getter
     @return The lib version number eg 180 = 1.8.0
@@ -727,243 +3152,249 @@ void ST7565_Parallel::LCDHighFreqDelaySet(uint16_t CommDelay)
     _HighFreqDelay = CommDelay;
 }
 
-void ST7565_Parallel::LCD_DrawIcon_phone(uint8_t icon)
+/*!
+    @brief Replace the icon row layout
+    @param table icon descriptors, must outlive the object, nullptr disables the icons
+    @param count entries in table
+    @note The icon row buffer is not cleared, call LCDclearBuffer for a blank row.
+ */
+void ST7565_Parallel::LCDIconTableSet(const LCD_IconDesc_t *table, uint8_t count)
 {
+    _iconTable = table;
+    _iconCount = (table == nullptr) ? 0 : count;
+}
 
-    // 使用 InactiveBuffer 的 screenBuffer 来更新图标
-    uint8_t *ST7565_Buffer_logo = _InactiveBuffer;
-
-    if (icon == 0)
-    {
-        ST7565_Buffer_logo[2] = 0x00;
-        ST7565_Buffer_logo[3] = 0x00;
-        ST7565_Buffer_logo[4] = 0x00;
-    }
-    else if (icon == 1)
-    {
-        ST7565_Buffer_logo[2] = 0xFF;
-        ST7565_Buffer_logo[3] = 0x00; // 保持第3列不变
-        ST7565_Buffer_logo[4] = 0xFF;
-    }
-    else if (icon == 2)
+/*!
+    @brief Set one icon of the status row
+    @param icon index into the icon table, LCD_Icon_e for the default table
+    @param state pattern to show, 0 is normally off
+    @return LCD_IconRange for an unknown icon or state, LCD_Success otherwise
+    @note Only columns whose byte changes are marked for the next update.
+ */
+LCD_Return_Codes_e ST7565_Parallel::setIconState(uint8_t icon, uint8_t state)
+{
+    if (_InactiveBuffer == nullptr || icon >= _iconCount || state >= _iconTable[icon].states)
     {
-        ST7565_Buffer_logo[2] = 0x00; // 保持第2列不变
-        ST7565_Buffer_logo[3] = 0xFF;
-        ST7565_Buffer_logo[4] = 0xFF;
+        return LCD_IconRange;
     }
-
-    // 最��，调用更新函数将缓冲区内容刷新到屏幕
-    // LCD_UpdateScreen();
+    LCD_IconWrite(icon, state);
+    return LCD_Success;
 }
 
-void ST7565_Parallel::LCD_DrawIcon_Signal(uint8_t level)
+/*!
+    @brief Set many icons of the status row at once
+    @param states one state per icon, from icon 0, LCD_ICON_KEEP leaves an icon as it is
+    @param count entries in states
+    @return LCD_IconRange if an entry is outside the table (the others are still
+    set), LCD_Success otherwise
+    @note The changed columns are sent by the next update or by LCDupdateIcons
+    as one burst on page 8.
+ */
+LCD_Return_Codes_e ST7565_Parallel::setIconStates(const uint8_t *states, uint8_t count)
 {
-    // 使用 InactiveBuffer 的 screenBuffer 来更新图标
-    uint8_t *ST7565_Buffer_logo = _InactiveBuffer;
-    if (level == 0)
+    if (states == nullptr || _InactiveBuffer == nullptr)
     {
-        // 仅设置缓冲区中第20列的数据
-        ST7565_Buffer_logo[20] = 0x00;
-        ST7565_Buffer_logo[22] = 0x00;
-        ST7565_Buffer_logo[24] = 0x00;
-        ST7565_Buffer_logo[26] = 0x00;
-        ST7565_Buffer_logo[28] = 0x00;
-        ST7565_Buffer_logo[30] = 0x00;
+        return LCD_IconRange;
     }
-    else if (level > 0 && level <= 20)
+    LCD_Return_Codes_e result = LCD_Success;
+    for (uint8_t icon = 0; icon < count; icon++)
     {
-        // 设置缓冲区中第22列的数据
-        ST7565_Buffer_logo[20] = 0xFF;
-        ST7565_Buffer_logo[22] = 0xFF;
+        if (states[icon] == LCD_ICON_KEEP)
+        {
+            continue;
+        }
+        if (icon >= _iconCount || states[icon] >= _iconTable[icon].states)
+        {
+            result = LCD_IconRange;
+            continue;
+        }
+        LCD_IconWrite(icon, states[icon]);
     }
-    else if (level > 20 && level <= 50)
+    return result;
+}
+
+/*!
+    @brief Send only the changed columns of the icon row, the display pages are left alone
+    @note One page/column address and one burst, however many icons changed.
+    Does nothing while LCDbeginAsync is still sending the power-on sequence.
+ */
+void ST7565_Parallel::LCDupdateIcons()
+{
+    if (!LCD_InitReady())
     {
-        // 设置缓冲区中第22列和第24列的数据
-        ST7565_Buffer_logo[20] = 0xFF;
-        ST7565_Buffer_logo[22] = 0xFF;
-        ST7565_Buffer_logo[24] = 0xFF;
+        return;
     }
-    else if (level > 50 && level <= 80)
+    // 等待未完成的异步刷新
+    while (_asyncBusy)
     {
-        // 设置缓冲区中第22列、第24列和第26列的数据
-        ST7565_Buffer_logo[20] = 0xFF;
-        ST7565_Buffer_logo[22] = 0xFF;
-        ST7565_Buffer_logo[24] = 0xFF;
-        ST7565_Buffer_logo[26] = 0xFF;
     }
-    else if (level > 80 && level < 100)
+    // 行遍历直接从图标行开始，显示页的脏列范围保留给下一次刷新
+    bool diffValid = _diffValid;
+    LCD_FrameStart();
+    _asyncRow = this->ActiveBuffer->height / 8;
+    while (LCD_AsyncNextRow())
     {
-        // 设置缓冲区中第22列、第24列、第26列和第28列的数据
-        ST7565_Buffer_logo[20] = 0xFF;
-        ST7565_Buffer_logo[22] = 0xFF;
-        ST7565_Buffer_logo[24] = 0xFF;
-        ST7565_Buffer_logo[26] = 0xFF;
-        ST7565_Buffer_logo[28] = 0xFF;
+        LCD_SetPageColumn(_asyncCur.page, _asyncCur.column);
+        ST7565_send_data_burst(_asyncCur.data, _asyncCur.len);
     }
-    else if (level >= 100)
+    _diffValid = diffValid;
+}
+
+/*!
+    @brief Copy the pattern of an icon state into the icon row
+    @param icon index into the icon table, checked by the caller
+    @param state pattern index, checked by the caller
+    @return true if any column changed
+ */
+bool ST7565_Parallel::LCD_IconWrite(uint8_t icon, uint8_t state)
+{
+    const LCD_IconDesc_t &desc = _iconTable[icon];
+    const uint8_t *pattern = &desc.patterns[state * desc.width];
+    int16_t first = -1;
+    int16_t last = -1;
+    for (uint8_t i = 0; i < desc.width; i++)
     {
-        // 设置缓冲区中第22列、第24列、第26列、第28列和第30列的数据
-        ST7565_Buffer_logo[20] = 0xFF;
-        ST7565_Buffer_logo[22] = 0xFF;
-        ST7565_Buffer_logo[24] = 0xFF;
-        ST7565_Buffer_logo[26] = 0xFF;
-        ST7565_Buffer_logo[28] = 0xFF;
-        ST7565_Buffer_logo[30] = 0xFF;
+        uint16_t column = desc.column + i;
+        if (column >= _iconwidthScreen)
+        {
+            break;
+        }
+        if (_InactiveBuffer[column] != pattern[i])
+        {
+            _InactiveBuffer[column] = pattern[i];
+            if (first < 0)
+            {
+                first = column;
+            }
+            last = column;
+        }
     }
-    else
+    if (first < 0)
     {
-        // 处理其他情况
+        return false;
     }
+    LCD_IconDirty(first, last);
+    return true;
 }
 
-void ST7565_Parallel::LCD_DrawIcon_Printer(uint8_t status)
+/*!
+    @brief Phone icon
+    @param icon state 0-2, see LCD_IconPatterns_Phone
+ */
+void ST7565_Parallel::LCD_DrawIcon_phone(uint8_t icon)
 {
+    setIconState(LCD_Icon_Phone, icon);
+}
 
-    // 使用 InactiveBuffer 的 screenBuffer 来更新图标
-    uint8_t *ST7565_Buffer_logo = _InactiveBuffer;
-
-    if (status == 1)
+/*!
+    @brief Signal icon
+    @param level 0-100, shown as 0-5 bars
+ */
+void ST7565_Parallel::LCD_DrawIcon_Signal(uint8_t level)
+{
+    uint8_t bars;
+    if (level == 0)
     {
-        // 将第42列的数据设置为0xFF
-        ST7565_Buffer_logo[42] = 0xFF;
+        bars = 0;
     }
-    else if (status == 0)
+    else if (level <= 20)
     {
-        // 将第42列的数据设置为0x00
-        ST7565_Buffer_logo[42] = 0x00;
+        bars = 1;
     }
-    else
+    else if (level <= 50)
     {
-        // 处理其他情况
+        bars = 2;
     }
-}
-
-void ST7565_Parallel::LCD_DrawIcon_Card(uint8_t status)
-{
-    // 使用 InactiveBuffer 的 screenBuffer 来更新图标
-    uint8_t *ST7565_Buffer_logo = _InactiveBuffer;
-    if (status == 1)
+    else if (level <= 80)
     {
-        // 将第61列的数据设置为0xFF
-        ST7565_Buffer_logo[61] = 0xFF;
+        bars = 3;
     }
-    else if (status == 0)
+    else if (level < 100)
     {
-        // 将第61列的数据设置为0x00
-        ST7565_Buffer_logo[61] = 0x00;
+        bars = 4;
     }
     else
     {
-        // 处理其他情况
+        bars = 5;
     }
+    setIconState(LCD_Icon_Signal, bars);
 }
 
-void ST7565_Parallel::LCD_DrawIcon_Battery(uint8_t level)
+/*!
+    @brief Printer icon
+    @param status 0 off, 1 on
+ */
+void ST7565_Parallel::LCD_DrawIcon_Printer(uint8_t status)
+{
+    setIconState(LCD_Icon_Printer, status);
+}
+
+/*!
+    @brief Card icon
+    @param status 0 off, 1 on
+ */
+void ST7565_Parallel::LCD_DrawIcon_Card(uint8_t status)
 {
-    // 使用 InactiveBuffer 的 screenBuffer 来更新图标
-    uint8_t *ST7565_Buffer_logo = _InactiveBuffer;
+    setIconState(LCD_Icon_Card, status);
+}
 
+/*!
+    @brief Battery icon
+    @param level 0-100, shown as 0-4 bars, larger values are ignored
+ */
+void ST7565_Parallel::LCD_DrawIcon_Battery(uint8_t level)
+{
+    uint8_t bars;
     if (level == 0)
     {
-
-        // 显示电池图标 0 格
-        ST7565_Buffer_logo[93] = 0x00;
-        ST7565_Buffer_logo[99] = 0x00;
-        ST7565_Buffer_logo[101] = 0x00;
-        ST7565_Buffer_logo[103] = 0x00;
-        ST7565_Buffer_logo[105] = 0x00;
+        bars = 0;
     }
-
-    // 根据电量等级绘制电池电量
-    else if (level > 0 && level <= 20)
+    else if (level <= 20)
+    {
+        bars = 1;
+    }
+    else if (level <= 50)
     {
-        // 显示电池图标 1 格
-        ST7565_Buffer_logo[93] = 0xFF;
-        ST7565_Buffer_logo[105] = 0xFF;
+        bars = 2;
     }
-    else if (level > 20 && level <= 50)
+    else if (level <= 80)
     {
-        // 显示电池图标 2 格
-        ST7565_Buffer_logo[93] = 0xFF;
-        ST7565_Buffer_logo[103] = 0xFF;
-        ST7565_Buffer_logo[105] = 0xFF;
+        bars = 3;
     }
-    else if (level > 50 && level <= 80)
+    else if (level <= 100)
     {
-        // 显示电池图标 3 格
-        ST7565_Buffer_logo[93] = 0xFF;
-        ST7565_Buffer_logo[101] = 0xFF;
-        ST7565_Buffer_logo[103] = 0xFF;
-        ST7565_Buffer_logo[105] = 0xFF;
+        bars = 4;
     }
-    else if (level > 80 && level <= 100)
+    else
     {
-        // 显示电池图标 4 格
-        ST7565_Buffer_logo[93] = 0xFF;
-        ST7565_Buffer_logo[99] = 0xFF;
-        ST7565_Buffer_logo[101] = 0xFF;
-        ST7565_Buffer_logo[103] = 0xFF;
-        ST7565_Buffer_logo[105] = 0xFF;
+        return;
     }
+    setIconState(LCD_Icon_Battery, bars);
 }
 
+/*!
+    @brief Lock icon
+    @param status 0 off, 1 on
+ */
 void ST7565_Parallel::LCD_DrawIcon_Lock(uint8_t status)
 {
-    // 使用 InactiveBuffer 的 screenBuffer 来更新图标
-    uint8_t *ST7565_Buffer_logo = _InactiveBuffer;
-    if (status == 1)
-    {
-        // 显示锁图标
-        ST7565_Buffer_logo[77] = 0xFF;
-    }
-    else if (status == 0)
-    {
-        // 隐藏锁图标
-        ST7565_Buffer_logo[77] = 0x00;
-    }
-    else
-    {
-        // 处理其他状态
-        // 你可以在这里处理异常状态或不显示任何内容
-    }
+    setIconState(LCD_Icon_Lock, status);
 }
 
+/*!
+    @brief Upload icon
+    @param status 0 off, 1 on
+ */
 void ST7565_Parallel::LCD_DrawIcon_Upload(uint8_t status)
 {
-    // 使用 InactiveBuffer 的 screenBuffer 来更新图标
-    uint8_t *ST7565_Buffer_logo = _InactiveBuffer;
-    if (status == 0)
-    {
-        // 显示上传图标
-        ST7565_Buffer_logo[108] = 0x00;
-        // 根���上传图标的结构设置更多列，如果有的话
-    }
-    else if (status == 1)
-    {
-        // 隐藏上传图标
-        ST7565_Buffer_logo[108] = 0xFF;
-        // 清除上传图标的更多列
-    }
+    setIconState(LCD_Icon_Upload, status);
 }
 
+/*!
+    @brief Download icon
+    @param status 0 off, 1 on
+ */
 void ST7565_Parallel::LCD_DrawIcon_Download(uint8_t status)
 {
-    // 使用 InactiveBuffer 的 screenBuffer 来更新图标
-    uint8_t *ST7565_Buffer_logo = _InactiveBuffer;
-    if (status == 1)
-    {
-        // 显示下载图标
-
-        ST7565_Buffer_logo[122] = 0xFF;
-    }
-    else if (status == 0)
-    {
-        // 隐藏下载图标
-        ST7565_Buffer_logo[122] = 0x00;
-        // 清除下载图标的更多列
-    }
-    else
-    {
-        // 处理其他状态（可以选择不显示任何内容或显示默认状态）
-    }
-}
\ No newline at end of file
+    setIconState(LCD_Icon_Download, status);
+}
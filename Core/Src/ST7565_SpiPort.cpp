@@ -0,0 +1,217 @@
+/*!
+    @file ST7565_SpiPort.cpp
+    @brief SPI hardware behind the 4-wire serial ST7565 bus backend, Source file.
+*/
+
+#include "ST7565_SpiPort.h"
+
+/*!
+    @brief init the SPI port object
+    @param config SPI and DMA channel wiring
+    @param cs GPIO Chip select
+    @param rst GPIO reset
+    @param a0 GPIO data or command
+ */
+ST7565_SpiPort_Hw::ST7565_SpiPort_Hw(const LCD_SpiConfig_t &config, LcdDataPin cs, LcdDataPin rst, LcdDataPin a0)
+{
+    _config = config;
+    _LCD_CS = cs;
+    _LCD_RST = rst;
+    _LCD_A0 = a0;
+}
+
+/*!
+    @brief Configure the pins, the SPI as transmit-only master and the DMA channel
+    @param maxHz fastest allowed SCL, at most LCD_SPI_MAX_HZ is used
+    @return false for an SPI other than SPI1/SPI2 or a clock below PCLK/256
+ */
+bool ST7565_SpiPort_Hw::begin(uint32_t maxHz)
+{
+    uint32_t pclk;
+    if (_config.spi == SPI1)
+    {
+        __HAL_RCC_SPI1_CLK_ENABLE();
+        pclk = HAL_RCC_GetPCLK2Freq();
+    }
+    else if (_config.spi == SPI2)
+    {
+        __HAL_RCC_SPI2_CLK_ENABLE();
+        pclk = HAL_RCC_GetPCLK1Freq();
+    }
+    else
+    {
+        return false;
+    }
+    if (maxHz > LCD_SPI_MAX_HZ)
+    {
+        maxHz = LCD_SPI_MAX_HZ;
+    }
+
+    // SCL = PCLK / 2^(BR+1)，取不超过 maxHz 的最快时钟
+    uint32_t br = 0;
+    while ((pclk >> (br + 1)) > maxHz)
+    {
+        if (++br > 7)
+        {
+            return false;
+        }
+    }
+    _clockHz = pclk >> (br + 1);
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+
+    LcdDataPin outputs[3] = {_LCD_CS, _LCD_RST, _LCD_A0};
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+    for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); i++)
+    {
+        GPIO_InitStruct.Pin = outputs[i].pin;
+        HAL_GPIO_Init(outputs[i].port, &GPIO_InitStruct);
+    }
+    _LCD_CS.port->BSRR = _LCD_CS.pin;
+    _LCD_RST.port->BSRR = _LCD_RST.pin;
+
+    LcdDataPin alternate[2] = {_config.sck, _config.mosi};
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    for (size_t i = 0; i < sizeof(alternate) / sizeof(alternate[0]); i++)
+    {
+        GPIO_InitStruct.Pin = alternate[i].pin;
+        HAL_GPIO_Init(alternate[i].port, &GPIO_InitStruct);
+    }
+
+    // 单线只发送主机，模式 3，高位在前，软件片选
+    SPI_TypeDef *spi = _config.spi;
+    spi->CR1 = 0;
+    spi->CR2 = 0;
+    spi->CR1 = SPI_CR1_BIDIMODE | SPI_CR1_BIDIOE | SPI_CR1_SSM | SPI_CR1_SSI | SPI_CR1_MSTR |
+               SPI_CR1_CPOL | SPI_CR1_CPHA | (br << SPI_CR1_BR_Pos);
+    spi->CR1 |= SPI_CR1_SPE;
+
+    _dmaIndex = (uint8_t)(((uintptr_t)_config.dma - (uintptr_t)DMA1_Channel1) / ((uintptr_t)DMA1_Channel2 - (uintptr_t)DMA1_Channel1));
+    _config.dma->CCR = 0;
+    _config.dma->CPAR = (uint32_t)(uintptr_t)&spi->DR;
+
+    HAL_NVIC_SetPriority(_config.dmaIRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(_config.dmaIRQn);
+    return true;
+}
+
+/*!
+    @brief Getter for the SCL frequency chosen in begin
+    @return Hz, 0 before begin
+ */
+uint32_t ST7565_SpiPort_Hw::getClockHz(void)
+{
+    return _clockHz;
+}
+
+/*!
+    @brief Drive the reset line
+    @param active true pulls RST low
+ */
+void ST7565_SpiPort_Hw::reset(bool active)
+{
+    _LCD_RST.port->BSRR = active ? ((uint32_t)_LCD_RST.pin << 16) : _LCD_RST.pin;
+}
+
+/*!
+    @brief Drive CS1
+    @param active true pulls CS low
+ */
+void ST7565_SpiPort_Hw::select(bool active)
+{
+    _LCD_CS.port->BSRR = active ? ((uint32_t)_LCD_CS.pin << 16) : _LCD_CS.pin;
+}
+
+/*!
+    @brief Drive A0
+    @param data true sets A0 high
+ */
+void ST7565_SpiPort_Hw::setA0(bool data)
+{
+    _LCD_A0.port->BSRR = data ? _LCD_A0.pin : ((uint32_t)_LCD_A0.pin << 16);
+}
+
+/*!
+    @brief Write bytes into DR as soon as TXE allows, then wait for the shifter
+    @param data bytes to send
+    @param len number of bytes
+    @param step 1 walks through data, 0 repeats data[0] len times
+ */
+void ST7565_SpiPort_Hw::write(const uint8_t *data, uint16_t len, uint8_t step)
+{
+    SPI_TypeDef *spi = _config.spi;
+    for (uint16_t i = 0; i < len; i++)
+    {
+        while ((spi->SR & SPI_SR_TXE) == 0)
+        {
+        }
+        *(volatile uint8_t *)&spi->DR = *data;
+        data += step;
+    }
+    waitIdle();
+}
+
+/*!
+    @brief Arm the DMA channel and let SPI TX requests drain the burst
+    @param data bytes to send
+    @param len number of bytes
+    @param step 1 walks through data, 0 repeats data[0] len times
+    @param interrupt true enables the transfer complete interrupt
+ */
+void ST7565_SpiPort_Hw::start(const uint8_t *data, uint16_t len, uint8_t step, bool interrupt)
+{
+    if (step == 0)
+    {
+        _fill = *data;
+        data = &_fill;
+    }
+
+    DMA_Channel_TypeDef *dma = _config.dma;
+    dma->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF1 << (4 * _dmaIndex);
+    dma->CMAR = (uint32_t)(uintptr_t)data;
+    dma->CNDTR = len;
+    dma->CCR = DMA_CCR_DIR | (step ? DMA_CCR_MINC : 0) | DMA_CCR_PL_1 | (interrupt ? DMA_CCR_TCIE : 0) | DMA_CCR_EN;
+    _config.spi->CR2 |= SPI_CR2_TXDMAEN;
+}
+
+/*!
+    @brief Acknowledge the DMA transfer complete flag
+    @return true when the burst is finished
+    @note DMA completes when the last byte is in DR, the shifter still needs
+    up to two byte times, so this waits for BSY to clear before the caller
+    releases CS.
+ */
+bool ST7565_SpiPort_Hw::complete(void)
+{
+    uint32_t tcif = DMA_ISR_TCIF1 << (4 * _dmaIndex);
+    if ((DMA1->ISR & tcif) == 0)
+    {
+        return false;
+    }
+    DMA1->IFCR = DMA_IFCR_CGIF1 << (4 * _dmaIndex);
+    _config.dma->CCR = 0;
+    _config.spi->CR2 &= ~SPI_CR2_TXDMAEN;
+    waitIdle();
+    return true;
+}
+
+/*!
+    @brief Wait until the last byte has been shifted out
+ */
+void ST7565_SpiPort_Hw::waitIdle(void)
+{
+    SPI_TypeDef *spi = _config.spi;
+    while ((spi->SR & SPI_SR_TXE) == 0)
+    {
+    }
+    while (spi->SR & SPI_SR_BSY)
+    {
+    }
+}
@@ -8,6 +8,7 @@
 */
 
 #include "ST7565_graphics.h"
+#include "ST7565_graphics_t.h"
 #include "ST7565_graphics_font.h"
 
 /*!
@@ -31,110 +32,24 @@ ST7565_graphics::ST7565_graphics(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h)
 
 void ST7565_graphics::drawCircle(int16_t x0, int16_t y0, int16_t r,
 		uint8_t color) {
-	int16_t f = 1 - r;
-	int16_t ddF_x = 1;
-	int16_t ddF_y = -2 * r;
-	int16_t x = 0;
-	int16_t y = r;
-
-	drawPixel(x0  , y0+r, color);
-	drawPixel(x0  , y0-r, color);
-	drawPixel(x0+r, y0  , color);
-	drawPixel(x0-r, y0  , color);
-
-	while (x<y) {
-		if (f >= 0) {
-			y--;
-			ddF_y += 2;
-			f += ddF_y;
-		}
-		x++;
-		ddF_x += 2;
-		f += ddF_x;
-	
-		drawPixel(x0 + x, y0 + y, color);
-		drawPixel(x0 - x, y0 + y, color);
-		drawPixel(x0 + x, y0 - y, color);
-		drawPixel(x0 - x, y0 - y, color);
-		drawPixel(x0 + y, y0 + x, color);
-		drawPixel(x0 - y, y0 + x, color);
-		drawPixel(x0 + y, y0 - x, color);
-		drawPixel(x0 - y, y0 - x, color);
-	}
+	LCD_DrawCircle(*this, x0, y0, r, color);
 }
 
 void ST7565_graphics::drawCircleHelper( int16_t x0, int16_t y0,
 							 int16_t r, uint8_t cornername, uint8_t color) {
-	int16_t f     = 1 - r;
-	int16_t ddF_x = 1;
-	int16_t ddF_y = -2 * r;
-	int16_t x     = 0;
-	int16_t y     = r;
-
-	while (x<y) {
-		if (f >= 0) {
-			y--;
-			ddF_y += 2;
-			f     += ddF_y;
-		}
-		x++;
-		ddF_x += 2;
-		f     += ddF_x;
-		if (cornername & 0x4) {
-			drawPixel(x0 + x, y0 + y, color);
-			drawPixel(x0 + y, y0 + x, color);
-		} 
-		if (cornername & 0x2) {
-			drawPixel(x0 + x, y0 - y, color);
-			drawPixel(x0 + y, y0 - x, color);
-		}
-		if (cornername & 0x8) {
-			drawPixel(x0 - y, y0 + x, color);
-			drawPixel(x0 - x, y0 + y, color);
-		}
-		if (cornername & 0x1) {
-			drawPixel(x0 - y, y0 - x, color);
-			drawPixel(x0 - x, y0 - y, color);
-		}
-	}
+	LCD_DrawCircleHelper(*this, x0, y0, r, cornername, color);
 }
 
 
 void ST7565_graphics::fillCircle(int16_t x0, int16_t y0, int16_t r,
 						uint8_t color) {
-	drawFastVLine(x0, y0-r, 2*r+1, color);
-	fillCircleHelper(x0, y0, r, 3, 0, color);
+	LCD_FillCircle(*this, x0, y0, r, color);
 }
 
 
 void ST7565_graphics::fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
 		uint8_t cornername, int16_t delta, uint8_t color) {
-
-	int16_t f     = 1 - r;
-	int16_t ddF_x = 1;
-	int16_t ddF_y = -2 * r;
-	int16_t x     = 0;
-	int16_t y     = r;
-
-	while (x<y) {
-		if (f >= 0) {
-			y--;
-			ddF_y += 2;
-			f     += ddF_y;
-		}
-		x++;
-		ddF_x += 2;
-		f     += ddF_x;
-
-		if (cornername & 0x1) {
-			drawFastVLine(x0+x, y0-y, 2*y+1+delta, color);
-			drawFastVLine(x0+y, y0-x, 2*x+1+delta, color);
-		}
-		if (cornername & 0x2) {
-			drawFastVLine(x0-x, y0-y, 2*y+1+delta, color);
-			drawFastVLine(x0-y, y0-x, 2*x+1+delta, color);
-		}
-	}
+	LCD_FillCircleHelper(*this, x0, y0, r, cornername, delta, color);
 }
 /*!
     @brief: called by the print class after it converts the data to a character
@@ -200,6 +115,45 @@ uint32_t ST7565_graphics::write(uint8_t character)
 
 
 
+/*!
+    @brief Looks up the glyph of a character in the current font 1-6
+    @param character the character, already checked against the font range
+    @return first column byte of the glyph, nullptr for a font not in this build
+ */
+const uint8_t *ST7565_graphics::LCD_FontColumns(unsigned char character)
+{
+	uint16_t offset = (character - _CurrentFontoffset) * _CurrentFontWidth;
+	switch (_FontNumber)
+	{
+#ifdef UC1609_Font_One
+	case UC1609Font_Default:
+		return pFontDefaultptr + offset;
+#endif
+#ifdef UC1609_Font_Two
+	case UC1609Font_Thick:
+		return pFontThickptr + offset;
+#endif
+#ifdef UC1609_Font_Three
+	case UC1609Font_Seven_Seg:
+		return pFontSevenSegptr + offset;
+#endif
+#ifdef UC1609_Font_Four
+	case UC1609Font_Wide:
+		return pFontWideptr + offset;
+#endif
+#ifdef UC1609_Font_Five
+	case UC1609Font_Tiny:
+		return pFontTinyptr + offset;
+#endif
+#ifdef UC1609_Font_Six
+	case UC1609Font_Homespun:
+		return pFontHomeSpunptr + offset;
+#endif
+	default: // wrong font number
+		return nullptr;
+	}
+}
+
 /*!
     @brief  writes a char (c) on the LCD
     @param  x X coordinate
@@ -224,96 +178,7 @@ uint32_t ST7565_graphics::write(uint8_t character)
 LCD_Return_Codes_e ST7565_graphics::drawChar(int16_t x, int16_t y, unsigned char character,
 											   uint8_t color, uint8_t bg, uint8_t size)
 {
-
-	// 1. Check for wrong font
-	if (_FontNumber >= UC1609Font_Bignum)
-	{
-		return LCD_WrongFont;
-	}
-	// 2. Check for screen out of  bounds
-	if ((x >= _width) ||								  // Clip right
-		(y >= _height) ||								  // Clip bottom
-		((x + (_CurrentFontWidth + 1) * size - 1) < 0) || // Clip left
-		((y + _CurrentFontheight * size - 1) < 0))		  // Clip top
-	{
-		return LCD_CharScreenBounds;
-	}
-	// 3. Check for character out of font range bounds
-	if (character < _CurrentFontoffset || character >= (_CurrentFontLength + _CurrentFontoffset))
-	{
-		return LCD_CharFontASCIIRange;
-	}
-
-	for (int8_t i = 0; i < (_CurrentFontWidth + 1); i++)
-	{
-		uint8_t line;
-		if (i == _CurrentFontWidth)
-		{
-			line = 0x0;
-		}
-		else
-		{
-			switch (_FontNumber)
-			{
-#ifdef UC1609_Font_One
-			case UC1609Font_Default:
-				line = pgm_read_byte(pFontDefaultptr + ((character - _CurrentFontoffset) * _CurrentFontWidth) + i);
-				break;
-#endif
-#ifdef UC1609_Font_Two
-			case UC1609Font_Thick:
-				line = pgm_read_byte(pFontThickptr + ((character - _CurrentFontoffset) * _CurrentFontWidth) + i);
-				break;
-#endif
-#ifdef UC1609_Font_Three
-			case UC1609Font_Seven_Seg:
-				line = pgm_read_byte(pFontSevenSegptr + ((character - _CurrentFontoffset) * _CurrentFontWidth) + i);
-				break;
-#endif
-#ifdef UC1609_Font_Four
-			case UC1609Font_Wide:
-				line = pgm_read_byte(pFontWideptr + ((character - _CurrentFontoffset) * _CurrentFontWidth) + i);
-				break;
-#endif
-#ifdef UC1609_Font_Five
-			case UC1609Font_Tiny:
-				line = pgm_read_byte(pFontTinyptr + ((character - _CurrentFontoffset) * _CurrentFontWidth) + i);
-				break;
-#endif
-#ifdef UC1609_Font_Six
-			case UC1609Font_Homespun:
-				line = pgm_read_byte(pFontHomeSpunptr + ((character - _CurrentFontoffset) * _CurrentFontWidth) + i);
-				break;
-#endif
-			default: // wrong font number
-				return LCD_WrongFont;
-				break;
-			}
-		}
-		for (int8_t j = 0; j < _CurrentFontheight; j++)
-		{
-			if (line & 0x1)
-			{
-				if (size == 1) // default size
-					drawPixel(x + i, y + j, color);
-				else
-				{ // big size
-					fillRect(x + (i * size), y + (j * size), size, size, color);
-				}
-			}
-			else if (bg != color)
-			{
-				if (size == 1) // default size
-					drawPixel(x + i, y + j, bg);
-				else
-				{ // big size
-					fillRect(x + i * size, y + j * size, size, size, bg);
-				}
-			}
-			line >>= 1;
-		}
-	}
-	return LCD_Success;
+	return LCD_DrawChar(*this, x, y, character, color, bg, size);
 }
 
 /**
@@ -332,43 +197,7 @@ LCD_Return_Codes_e ST7565_graphics::drawChar(int16_t x, int16_t y, unsigned char
  */
 LCD_Return_Codes_e ST7565_graphics::drawText(uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg, uint8_t size)
 {
-    // check Correct font number
-    if (_FontNumber >= UC1609Font_Bignum)
-    {
-        return LCD_WrongFont;
-    }
-    // Check for null pointer
-    if (pText == nullptr)
-    {
-        return LCD_CharArrayNullptr;
-    }
-
-    LCD_Return_Codes_e DrawCharReturnCode;
-    uint8_t lcursorX;
-    uint8_t lcursorY;
-    lcursorX = x;
-    lcursorY = y;
-
-    while (*pText != '\0')
-    {
-        if (_textWrap && ((lcursorX + size * _CurrentFontWidth) > _width))
-        {
-            lcursorX = 0;
-            lcursorY = lcursorY + size * 7 + 3;
-            if (lcursorY > _height)
-                lcursorY = _height;
-        }
-        DrawCharReturnCode = drawChar(lcursorX, lcursorY, *pText, color, bg, size);
-        if (DrawCharReturnCode != LCD_Success)
-        {
-            return DrawCharReturnCode;
-        }
-        lcursorX = lcursorX + size * (_CurrentFontWidth + 1);
-        if (lcursorX > _width)
-            lcursorX = _width;
-        pText++;
-    }
-    return LCD_Success;
+    return LCD_DrawText(*this, x, y, pText, color, bg, size);
 }
 
 LCD_Return_Codes_e ST7565_graphics::drawChar(uint8_t x, uint8_t y, uint8_t character, uint8_t color, uint8_t bg)
@@ -528,22 +357,12 @@ void ST7565_graphics::fillScreen(uint8_t color) {
 
 void ST7565_graphics::drawRoundRect(int16_t x, int16_t y, int16_t w,
 	int16_t h, int16_t r, uint8_t color) {
-	drawFastHLine(x+r  , y    , w-2*r, color); // Top
-	drawFastHLine(x+r  , y+h-1, w-2*r, color); // Bottom
-	drawFastVLine(x    , y+r  , h-2*r, color); // Left
-	drawFastVLine(x+w-1, y+r  , h-2*r, color); // Right
-	// draw four corners
-	drawCircleHelper(x+r    , y+r    , r, 1, color);
-	drawCircleHelper(x+w-r-1, y+r    , r, 2, color);
-	drawCircleHelper(x+w-r-1, y+h-r-1, r, 4, color);
-	drawCircleHelper(x+r    , y+h-r-1, r, 8, color);
+	LCD_DrawRoundRect(*this, x, y, w, h, r, color);
 }
 
 void ST7565_graphics::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color)
 {
-	fillRect(x+r, y, w-2*r, h, color);
-	fillCircleHelper(x+w-r-1, y+r, r, 1, h-2*r-1, color);
-	fillCircleHelper(x+r    , y+r, r, 2, h-2*r-1, color);
+	LCD_FillRoundRect(*this, x, y, w, h, r, color);
 }
 
 
@@ -552,72 +371,14 @@ void ST7565_graphics::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h,
 void ST7565_graphics::drawTriangle(int16_t x0, int16_t y0,
 				int16_t x1, int16_t y1,
 				int16_t x2, int16_t y2, uint8_t color) {
-	drawLine(x0, y0, x1, y1, color);
-	drawLine(x1, y1, x2, y2, color);
-	drawLine(x2, y2, x0, y0, color);
+	LCD_DrawTriangle(*this, x0, y0, x1, y1, x2, y2, color);
 }
 
 
 void ST7565_graphics::fillTriangle ( int16_t x0, int16_t y0,
 					int16_t x1, int16_t y1,
 					int16_t x2, int16_t y2, uint8_t color) {
-
-	int16_t a, b, y, last;
-
-	if (y0 > y1) {
-		ST7565_swap(y0, y1); ST7565_swap(x0, x1);
-	}
-	if (y1 > y2) {
-		ST7565_swap(y2, y1); ST7565_swap(x2, x1);
-	}
-	if (y0 > y1) {
-		ST7565_swap(y0, y1); ST7565_swap(x0, x1);
-	}
-
-	if(y0 == y2) {
-		a = b = x0;
-		if(x1 < a)      a = x1;
-		else if(x1 > b) b = x1;
-		if(x2 < a)      a = x2;
-		else if(x2 > b) b = x2;
-		drawFastHLine(a, y0, b-a+1, color);
-		return;
-	}
-
-	int16_t
-		dx01 = x1 - x0,
-		dy01 = y1 - y0,
-		dx02 = x2 - x0,
-		dy02 = y2 - y0,
-		dx12 = x2 - x1,
-		dy12 = y2 - y1;
-	int32_t
-		sa   = 0,
-		sb   = 0;
-
-	if(y1 == y2) last = y1;   
-	else         last = y1-1; 
-
-	for(y=y0; y<=last; y++) {
-		a   = x0 + sa / dy01;
-		b   = x0 + sb / dy02;
-		sa += dx01;
-		sb += dx02;
-
-		if(a > b) ST7565_swap(a,b);
-		drawFastHLine(a, y, b-a+1, color);
-	}
-
-	sa = dx12 * (y - y1);
-	sb = dx02 * (y - y0);
-	for(; y<=y2; y++) {
-		a   = x1 + sa / dy12;
-		b   = x0 + sb / dy02;
-		sa += dx12;
-		sb += dx02;
-		if(a > b) ST7565_swap(a,b);
-		drawFastHLine(a, y, b-a+1, color);
-	}
+	LCD_FillTriangle(*this, x0, y0, x1, y1, x2, y2, color);
 }
 
 
@@ -712,42 +473,7 @@ void ST7565_graphics::drawFastVLine(int16_t x, int16_t y,
 void ST7565_graphics::drawLine(int16_t x0, int16_t y0,
 					int16_t x1, int16_t y1,
 					uint8_t color) {
-	int16_t steep = abs(y1 - y0) > abs(x1 - x0);
-	if (steep) {
-		ST7565_swap(x0, y0);
-		ST7565_swap(x1, y1);
-	}
-
-	if (x0 > x1) {
-		ST7565_swap(x0, x1);
-		ST7565_swap(y0, y1);
-	}
-
-	int16_t dx, dy;
-	dx = x1 - x0;
-	dy = abs(y1 - y0);
-
-	int16_t err = dx / 2;
-	int16_t ystep;
-
-	if (y0 < y1) {
-		ystep = 1;
-	} else {
-		ystep = -1;
-	}
-
-	for (; x0<=x1; x0++) {
-		if (steep) {
-			drawPixel(y0, x0, color);
-		} else {
-			drawPixel(x0, y0, color);
-		}
-		err -= dy;
-		if (err < 0) {
-			y0 += ystep;
-			err += dx;
-		}
-	}
+	LCD_DrawLine(*this, x0, y0, x1, y1, color);
 }
 
 
@@ -762,10 +488,7 @@ void ST7565_graphics::drawFastHLine(int16_t x, int16_t y,
 void ST7565_graphics::drawRect(int16_t x, int16_t y,
 					int16_t w, int16_t h,
 					uint8_t color) {
-	drawFastHLine(x, y, w, color);
-	drawFastHLine(x, y+h-1, w, color);
-	drawFastVLine(x, y, h, color);
-	drawFastVLine(x+w-1, y, h, color);
+	LCD_DrawRect(*this, x, y, w, h, color);
 }
 
 /**
@@ -834,6 +557,12 @@ int16_t ST7565_graphics::width(void) const {return _width;}
 
 int16_t ST7565_graphics::height(void) const {return _height;}
 
+/*!
+    @brief Gets the font selected by setFontNum
+    @return font enum value
+ */
+LCD_Font_Type_e ST7565_graphics::getFontNum(void) {return (LCD_Font_Type_e)_FontNumber;}
+
 void ST7565_graphics::setFontNum(LCD_Font_Type_e FontNumber)
 {
 
@@ -0,0 +1,64 @@
+/*
+ * dwt_delay.c
+ *
+ *  基于 DWT CYCCNT 的周期级延时实现。
+ */
+
+#include "dwt_delay.h"
+
+uint32_t dwt_cycles_per_us = 8; /* 复位后 HSI 8MHz */
+
+#ifdef DWT_DELAY_HOST_MOCK
+
+volatile uint32_t dwt_mock_cyccnt = 0;
+uint32_t dwt_mock_step = 1;
+
+/**
+ * @brief 初始化模拟计数器
+ */
+void dwt_delay_init(void)
+{
+    dwt_cycles_per_us = DWT_DELAY_HOST_CLOCK_HZ / 1000000U;
+    dwt_mock_cyccnt = 0;
+}
+
+/**
+ * @brief 设置模拟计数器的值
+ *
+ * @param cycles 新的计数值
+ */
+void dwt_mock_set(uint32_t cycles)
+{
+    dwt_mock_cyccnt = cycles;
+}
+
+/**
+ * @brief 使模拟计数器前进
+ *
+ * @param cycles 前进的周期数
+ */
+void dwt_mock_advance(uint32_t cycles)
+{
+    dwt_mock_cyccnt += cycles;
+}
+
+#else
+
+/**
+ * @brief 初始化 DWT 周期计数器
+ *
+ * 使能 DEMCR.TRCENA 后启动 CYCCNT，只需调用一次。
+ */
+void dwt_delay_init(void)
+{
+    dwt_cycles_per_us = SystemCoreClock / 1000000U;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+    {
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+#endif
@@ -6,6 +6,10 @@
 #include "stm32f1xx_hal_uart.h"
 #include "string.h"
 #include "ST7565_Parallel.h"
+#include "ST7565_Panel.h"
+#ifdef LCD_BENCHMARK
+#include "LCD_Benchmark.h"
+#endif
 #include <stdarg.h>
 #include <stdio.h> 
 
@@ -113,12 +117,6 @@
 #define MAX_INIT_ATTEMPTS 3
 static uint8_t init_attempts = 0;
 
-// 定义显示器的宽度和高度
-#define DISPLAY_WIDTH 128
-#define DISPLAY_HEIGHT 64
-
-#define FULLSCREEN (DISPLAY_WIDTH * (DISPLAY_HEIGHT / 8)) // 1536 bytes
-
 // 定义缓冲区以覆盖整个屏幕
 uint8_t screenBuffer[FULLSCREEN];
 
@@ -139,8 +137,19 @@ LcdDataPin dataPins[] = {
     {GPIOB, GPIO_PIN_15}  // D7
 };
 
+#ifdef LCD_BUS_SPI
+// 4 线串口：SCL(PA5)、SI(PA7) 由 SPI1 输出，A0 使用 dc 引脚，DMA1 通道3 发送整页
+ST7565_SpiPort_Hw lcdSpi(LCD_SpiConfig_SPI1, cs, rst, dc);
+ST7565_Bus_Spi lcdBus(&lcdSpi, LCD_SPI_MAX_HZ);
+#else
+// WR(PB0) 由 TIM1_CH2N 产生写脉冲，TIM1_CH1 比较事件触发 DMA1 通道2
+ST7565_DmaPort_Tim lcdDma(LCD_DmaConfig_TIM1_PB0);
+// 总线后端：寄存器 8080 + TIM1/DMA 异步刷新
+ST7565_Bus_TimDma lcdBus(cs, rst, dc, wr, rd, dataPins, &lcdDma);
+#endif
+
 // 定义 LCD 引脚结构体
-ST7565_Parallel mylcd(DISPLAY_WIDTH, DISPLAY_HEIGHT, cs, rst, dc, wr, rd, dataPins);
+ST7565_Parallel mylcd(DISPLAY_WIDTH, DISPLAY_HEIGHT, &lcdBus);
 ST7565_Parallel_Screen fullScreen(screenBuffer, DISPLAY_WIDTH, DISPLAY_HEIGHT, 0, 0);
 RTC_HandleTypeDef hrtc;
 UART_HandleTypeDef huart1;
@@ -154,6 +163,24 @@ void Set_RTC_Alarm(void);
 void MX_NVIC_Init(void);
 void HandleClockInitFailure(void);
 
+// 每 1ms 推进 LCD 上电序列
+extern "C" void HAL_SYSTICK_Callback(void)
+{
+  mylcd.LCDinitTick();
+}
+
+#ifdef LCD_BUS_SPI
+extern "C" void DMA1_Channel3_IRQHandler(void)
+{
+  mylcd.LCD_DMA_IRQHandler();
+}
+#else
+extern "C" void DMA1_Channel2_IRQHandler(void)
+{
+  mylcd.LCD_DMA_IRQHandler();
+}
+#endif
+
 uint32_t start_time, end_time;
 uint32_t elapsed_times[10]; // Array to store elapsed times
 int main(void)
@@ -179,6 +206,10 @@ int main(void)
   end_time = HAL_GetTick();
   elapsed_times[2] = end_time - start_time; // Time for MX_GPIO_Init()
 
+  // LCD 上电等待与后续外设初始化并行，由 SysTick 推进
+  mylcd.ActiveBuffer = &fullScreen; // Assign address of screen object to be the "active buffer" pointer
+  mylcd.LCDbeginAsync();
+
   // RTC Initialization
   start_time = HAL_GetTick();
   MX_RTC_Init();
@@ -212,8 +243,14 @@ int main(void)
   HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_SET); // 打开LED
   // MX_IWDG_Init();
 
-  mylcd.LCDbegin();                      // initialize the OLED                // 设置显示方向
-  mylcd.ActiveBuffer = &fullScreen;      // Assign address of screen object to be the "active buffer" pointer
+  while (!mylcd.LCDinitDone())
+  {
+  }
+  {
+    char buffer[50];
+    snprintf(buffer, sizeof(buffer), "LCD time to first frame: %lu ms\n", mylcd.LCDFirstFrameTimeGet());
+    UART_Print(buffer);
+  }
   mylcd.LCDclearBuffer();                // Clear a
   mylcd.setFontNum(UC1609Font_Default); // set font type
   mylcd.setTextColor(0x00, 0x01);        // set text color
@@ -264,7 +301,31 @@ int main(void)
     HAL_Delay(50);
   }
 
-  mylcd.LCDupdate(); // Update screen , write active buffer to screen
+  mylcd.LCDupdateAsync(); // Update screen in the background, write active buffer to screen
+
+#ifdef LCD_BENCHMARK
+  // 相同的绘图代码分别跑在各个总线后端上
+  while (mylcd.isBusy())
+  {
+  }
+#ifdef LCD_BUS_SPI
+  LCD_BenchmarkBus("spi", &lcdBus);
+#else
+  static ST7565_Bus_Gpio benchGpio(cs, rst, dc, wr, rd, dataPins);
+  static ST7565_Bus_Reg8080 benchReg(cs, rst, dc, wr, rd, dataPins);
+  LCD_BenchmarkBus("gpio", &benchGpio);
+  LCD_BenchmarkBus("reg8080", &benchReg);
+  LCD_BenchmarkBus("timdma", &lcdBus);
+#endif
+  LCD_BenchmarkStrip(&lcdBus);
+  // 上面的临时驱动复位过控制器，mylcd 的命令影子已失效，重新初始化并发送整帧
+  mylcd.LCDbegin();
+  LCD_BenchmarkBitBand();
+  LCD_BenchmarkFill();
+  LCD_BenchmarkCrtp();
+  LCD_BenchmarkRotation();
+  LCD_BenchmarkTranspose();
+#endif
 
   while (1)
   {
@@ -290,6 +351,7 @@ void UART_Print(const char *str)
   HAL_UART_Transmit(&huart1, (uint8_t *)str, strlen(str), HAL_MAX_DELAY);
 }
 
+
 void MX_USART1_UART_Init(void)
 {
   huart1.Instance = USART1;
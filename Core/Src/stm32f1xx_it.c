@@ -186,6 +186,7 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  HAL_SYSTICK_Callback();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -0,0 +1,25 @@
+/*!
+    @file hal_stubs.cpp
+    @brief HAL functions the driver calls, as no-ops for the host build.
+    @details The tick counter is a plain variable the tests advance by hand.
+*/
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+extern "C"
+{
+    uint32_t SystemCoreClock = 72000000;
+    volatile uint32_t uwTick;
+    void HAL_Delay(uint32_t) {}
+    uint32_t HAL_GetTick(void) { return uwTick; }
+    void HAL_GPIO_Init(GPIO_TypeDef *, GPIO_InitTypeDef *) {}
+    void HAL_GPIO_WritePin(GPIO_TypeDef *, uint16_t, GPIO_PinState) {}
+    void HAL_NVIC_SetPriority(IRQn_Type, uint32_t, uint32_t) {}
+    void HAL_NVIC_EnableIRQ(IRQn_Type) {}
+    uint32_t HAL_RCC_GetPCLK1Freq(void) { return 36000000; }
+    uint32_t HAL_RCC_GetPCLK2Freq(void) { return 72000000; }
+    void delay_us_init(void) {}
+    void delay_us(uint32_t) {}
+    void delay_ms(uint32_t) {}
+}
@@ -0,0 +1,62 @@
+/*!
+    @file host_fixture.h
+    @brief Shared helpers of the host tests: the recording bus models the
+    controller RAM, the helpers compare it with frame buffers.
+*/
+
+#ifndef HOST_FIXTURE_H
+#define HOST_FIXTURE_H
+
+#include <unity.h>
+#include <string.h>
+#include "ST7565_Parallel.h"
+#include "ST7565_Bus_Recording.h"
+
+/*! @brief Bytes of the glass (pages 0 to pages - 1) that differ from a frame buffer */
+static inline int glassDiff(const ST7565_Bus_Recording &rec, const uint8_t *buffer, uint8_t width = 128, uint8_t pages = 8)
+{
+    int bad = 0;
+    for (uint8_t page = 0; page < pages; page++)
+    {
+        for (uint8_t column = 0; column < width; column++)
+        {
+            if (rec.getRam(page, column) != buffer[page * width + column])
+            {
+                bad++;
+            }
+        }
+    }
+    return bad;
+}
+
+/*! @brief Bytes of the 128x64 glass that differ between two recording buses */
+static inline int glassDiff(const ST7565_Bus_Recording &a, const ST7565_Bus_Recording &b)
+{
+    int bad = 0;
+    for (uint8_t page = 0; page < 8; page++)
+    {
+        for (uint8_t column = 0; column < 128; column++)
+        {
+            if (a.getRam(page, column) != b.getRam(page, column))
+            {
+                bad++;
+            }
+        }
+    }
+    return bad;
+}
+
+/*!
+    @brief ST7565_Parallel drawing everything through drawPixel, the
+    reference for the page-mask fill engine and the other fast paths
+ */
+class ST7565_PixelReference : public ST7565_Parallel
+{
+public:
+    using ST7565_Parallel::ST7565_Parallel;
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint8_t colour) override { drawLine(x, y, x, y + h - 1, colour); }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint8_t colour) override { drawLine(x, y, x + w - 1, y, colour); }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t colour) override { ST7565_graphics::fillRect(x, y, w, h, colour); }
+};
+
+#endif // HOST_FIXTURE_H
@@ -0,0 +1,130 @@
+/*!
+    @file test_buffers.cpp
+    @brief Double buffering with LCDswap, and strip mode against a full
+    frame buffer.
+*/
+
+#include "host_fixture.h"
+
+static uint8_t buffer[128 * 8];
+static uint8_t front[128 * 8];
+static uint8_t sent[128 * 8];
+
+void test_double_buffer_needs_screen(void)
+{
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    TEST_ASSERT_EQUAL(LCD_ScreenNullptr, lcd.LCDDoubleBufferSet(front));
+    TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDDoubleBufferSet(nullptr));
+}
+
+void test_double_buffer_swap(void)
+{
+    for (int mode = LCD_Diff_Off; mode <= LCD_Diff_Hash; mode++)
+    {
+        memset(buffer, 0, sizeof(buffer));
+        ST7565_Bus_Recording rec;
+        rec.setAsync(true);
+        ST7565_Parallel lcd(128, 64, &rec);
+        ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+        lcd.ActiveBuffer = &screen;
+        lcd.LCDDiffModeSet((LCD_DiffMode_e)mode);
+        lcd.LCDbegin();
+        TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDDoubleBufferSet(front));
+
+        srand(3 + mode);
+        for (int frame = 0; frame < 150; frame++)
+        {
+            // 上一帧仍在发送时绘制下一帧
+            for (int k = 0; k < rand() % 25; k++)
+            {
+                lcd.drawPixel(rand() % 128, rand() % 64, rand() % 3);
+                if (lcd.isBusy() && rand() % 3 == 0)
+                {
+                    lcd.LCD_DMA_IRQHandler();
+                }
+            }
+            if (frame % 50 == 7)
+            {
+                lcd.LCDclearBuffer();
+            }
+            while (lcd.LCDswap() == LCD_BusBusy)
+            {
+                lcd.LCD_DMA_IRQHandler();
+            }
+            // copyBack 之后前后台一致
+            TEST_ASSERT_EQUAL_MEMORY(lcd.LCDFrontBufferGet(), screen.screenBuffer, sizeof(buffer));
+            memcpy(sent, lcd.LCDFrontBufferGet(), sizeof(sent));
+            lcd.LCDupdateAsync();
+            if (frame % 10 == 0)
+            {
+                while (lcd.isBusy())
+                {
+                    lcd.LCD_DMA_IRQHandler();
+                }
+                TEST_ASSERT_EQUAL(0, glassDiff(rec, sent));
+            }
+        }
+        while (lcd.isBusy())
+        {
+            lcd.LCD_DMA_IRQHandler();
+        }
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, sent));
+
+        TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDDoubleBufferSet(nullptr));
+        lcd.drawPixel(1, 1, FOREGROUND);
+        lcd.LCDupdate();
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, screen.screenBuffer));
+    }
+}
+
+void test_strip_matches_frame_buffer(void)
+{
+    static uint8_t strip[128];
+    static LCD_ListItem_t list[32];
+    static const uint8_t bitmap[8] = {0xFF, 0x81, 0xBD, 0xA5, 0xA5, 0xBD, 0x81, 0xFF};
+    char text[] = "Hello World";
+    for (int rotation = LCD_Degrees_0; rotation <= LCD_Degrees_270; rotation++)
+    {
+        memset(buffer, 0, sizeof(buffer));
+        ST7565_Bus_Recording full;
+        ST7565_Parallel a(128, 64, &full);
+        ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+        a.ActiveBuffer = &screen;
+        a.LCDbegin();
+        a.setRotation((LCD_rotate_e)rotation);
+        a.drawText(3, 5, text, FOREGROUND, BACKGROUND, 1);
+        a.drawRect(0, 0, 60, 30, FOREGROUND);
+        a.fillRect(10, 12, 40, 25, COLORINVERSE);
+        a.drawLine(0, 63, 50, 2, FOREGROUND);
+        a.drawCircle(30, 30, 12, FOREGROUND);
+        a.fillCircle(20, 40, 6, COLORINVERSE);
+        a.drawPixel(5, 50, FOREGROUND);
+        a.drawBitmap(40, 20, bitmap, 8, 8, FOREGROUND, BACKGROUND);
+        a.LCDupdate();
+
+        ST7565_Bus_Recording striped;
+        ST7565_Parallel b(128, 64, &striped);
+        b.LCDbegin();
+        b.setRotation((LCD_rotate_e)rotation);
+        TEST_ASSERT_EQUAL(LCD_Success, b.LCDStripBegin(list, 32, strip));
+        b.LCDListText(3, 5, text, FOREGROUND, BACKGROUND);
+        b.LCDListRect(0, 0, 60, 30, FOREGROUND);
+        b.LCDListFillRect(10, 12, 40, 25, COLORINVERSE);
+        b.LCDListLine(0, 63, 50, 2, FOREGROUND);
+        b.LCDListCircle(30, 30, 12, FOREGROUND);
+        b.LCDListFillCircle(20, 40, 6, COLORINVERSE);
+        b.LCDListPixel(5, 50, FOREGROUND);
+        b.LCDListBitmap(40, 20, bitmap, 8, 8, FOREGROUND, BACKGROUND);
+        TEST_ASSERT_EQUAL(8, b.LCDListLengthGet());
+        TEST_ASSERT_EQUAL(LCD_Success, b.LCDupdateStrip());
+        TEST_ASSERT_EQUAL(0, glassDiff(full, striped));
+    }
+
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel c(128, 64, &rec);
+    c.LCDStripBegin(list, 2, strip);
+    TEST_ASSERT_EQUAL(LCD_Success, c.LCDListPixel(1, 1, FOREGROUND));
+    TEST_ASSERT_EQUAL(LCD_Success, c.LCDListPixel(2, 1, FOREGROUND));
+    TEST_ASSERT_EQUAL(LCD_ListFull, c.LCDListPixel(3, 1, FOREGROUND));
+}
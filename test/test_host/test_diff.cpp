@@ -0,0 +1,183 @@
+/*!
+    @file test_diff.cpp
+    @brief Shadow and hash change detection, and region updates, in every
+    diff mode.
+*/
+
+#include "host_fixture.h"
+
+static uint8_t buffer[128 * 8];
+
+void test_diff_shadow_sends_changed_bytes(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDDiffModeSet(LCD_Diff_Shadow));
+    lcd.LCDbegin();
+
+    lcd.fillRect(10, 30, 60, 8, FOREGROUND);
+    lcd.LCDupdate();
+    // 重画相同内容：脏列存在但字节未变
+    lcd.fillRect(10, 30, 60, 8, FOREGROUND);
+    rec.clear();
+    lcd.LCDupdate();
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getDataBytes());
+    TEST_ASSERT_EQUAL_UINT32(120, lcd.LCDDiffSavedBytesGet());
+
+    lcd.fillRect(10, 30, 60, 8, FOREGROUND);
+    lcd.drawPixel(40, 31, BACKGROUND);
+    rec.clear();
+    lcd.LCDupdate();
+    TEST_ASSERT_EQUAL_UINT32(1, rec.getDataBytes());
+    TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+}
+
+void test_diff_hash_skips_unchanged_chunks(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDDiffModeSet(LCD_Diff_Hash));
+    lcd.LCDbegin();
+
+    lcd.fillRect(10, 30, 60, 8, FOREGROUND);
+    lcd.LCDupdate();
+    lcd.fillRect(10, 30, 60, 8, FOREGROUND);
+    rec.clear();
+    lcd.LCDupdate();
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getDataBytes());
+    TEST_ASSERT_EQUAL_UINT32(lcd.LCDDiffChunksGet(), lcd.LCDDiffChunkHitsGet());
+    TEST_ASSERT_TRUE(lcd.LCDDiffRamGet() < 128 * 9);
+}
+
+void test_diff_modes_random(void)
+{
+    for (int mode = LCD_Diff_Off; mode <= LCD_Diff_Hash; mode++)
+    {
+        memset(buffer, 0, sizeof(buffer));
+        ST7565_Bus_Recording rec;
+        rec.setAsync(true);
+        ST7565_Parallel lcd(128, 64, &rec);
+        ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+        lcd.ActiveBuffer = &screen;
+        lcd.LCDDiffModeSet((LCD_DiffMode_e)mode);
+        lcd.LCDbegin();
+        srand(mode);
+        for (int frame = 0; frame < 150; frame++)
+        {
+            for (int k = 0; k < rand() % 30; k++)
+            {
+                lcd.drawPixel(rand() % 128, rand() % 64, rand() % 3);
+            }
+            if (frame == 75)
+            {
+                lcd.LCDDiffMergeGapSet(20);
+            }
+            if (frame % 3 == 0)
+            {
+                lcd.LCDupdate();
+            }
+            else if (frame % 3 == 1)
+            {
+                lcd.LCDupdateIT(1 + rand() % 9);
+                while (lcd.isBusy())
+                {
+                    lcd.LCDrefreshTick();
+                }
+            }
+            else
+            {
+                lcd.LCDupdateAsync();
+                while (lcd.isBusy())
+                {
+                    lcd.LCD_DMA_IRQHandler();
+                }
+            }
+            TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+        }
+    }
+}
+
+void test_update_regions(void)
+{
+    for (int mode = LCD_Diff_Off; mode <= LCD_Diff_Hash; mode++)
+    {
+        memset(buffer, 0, sizeof(buffer));
+        ST7565_Bus_Recording rec;
+        ST7565_Parallel lcd(128, 64, &rec);
+        ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+        lcd.ActiveBuffer = &screen;
+        lcd.LCDDiffModeSet((LCD_DiffMode_e)mode);
+        lcd.LCDbegin();
+
+        lcd.fillRect(10, 10, 20, 20, FOREGROUND);
+        lcd.LCDupdateRegion(10, 10, 20, 20);
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+
+        // 区域外的像素留到下一次 LCDupdate
+        lcd.drawPixel(100, 0, FOREGROUND);
+        lcd.LCDupdateRegion(0, 0, 10, 8);
+        TEST_ASSERT_EQUAL_HEX8(0x00, rec.getRam(0, 100));
+        lcd.LCDupdate();
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+
+        srand(2 + mode);
+        for (int frame = 0; frame < 200; frame++)
+        {
+            int x = rand() % 128, y = rand() % 64, w = 1 + rand() % 40, h = 1 + rand() % 30;
+            if (frame == 100)
+            {
+                lcd.setRotation(LCD_Degrees_90);
+            }
+            lcd.fillRect(x, y, w, h, rand() % 3);
+            if (frame % 4 == 0)
+            {
+                lcd.LCDupdate();
+            }
+            else
+            {
+                LCD_Rect_t rects[2] = {{(int16_t)x, (int16_t)y, (uint8_t)w, (uint8_t)h}, {0, 0, 1, 1}};
+                lcd.LCDupdateRegions(rects, 2);
+            }
+            TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+        }
+    }
+}
+
+void test_update_region_resends_glass(void)
+{
+    static const uint8_t noise[16] = {0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+                                      0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55};
+    // 第 1 页、第 36 列
+    static const uint8_t address[3] = {0xB1, 0x12, 0x04};
+    for (int mode = LCD_Diff_Off; mode <= LCD_Diff_Hash; mode++)
+    {
+        memset(buffer, 0, sizeof(buffer));
+        ST7565_Bus_Recording rec;
+        ST7565_Parallel lcd(128, 64, &rec);
+        ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+        lcd.ActiveBuffer = &screen;
+        lcd.LCDDiffModeSet((LCD_DiffMode_e)mode);
+        lcd.LCDbegin();
+        lcd.fillRect(0, 8, 128, 16, FOREGROUND);
+        lcd.LCDupdate();
+
+        // 总线干扰写坏了一段玻璃，缓冲区和影子都没变
+        rec.sendCommands(address, sizeof(address));
+        rec.sendData(noise, sizeof(noise));
+        TEST_ASSERT_TRUE(glassDiff(rec, buffer) > 0);
+        lcd.LCDupdateRegion(30, 8, 30, 8);
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+
+        // 之后的差分刷新仍以发出的内容为准
+        lcd.drawPixel(40, 9, BACKGROUND);
+        lcd.fillRect(100, 40, 8, 8, FOREGROUND);
+        lcd.LCDupdate();
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+    }
+}
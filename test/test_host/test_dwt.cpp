@@ -0,0 +1,54 @@
+/*!
+    @file test_dwt.cpp
+    @brief DWT cycle delays and the wrap-safe deadline against the host
+    mock counter.
+*/
+
+#include <unity.h>
+#include "dwt_delay.h"
+
+void test_dwt_mock_delay(void)
+{
+    dwt_mock_set(0);
+    uint32_t start = dwt_cycles();
+    delay_cycles(1000);
+    TEST_ASSERT_TRUE(dwt_cycles() - start >= 1000);
+}
+
+void test_dwt_wait_until_wraps(void)
+{
+    // 截止时刻越过 32 位回绕，无符号比较会立即返回
+    dwt_mock_set(0xFFFFFF00);
+    uint32_t start = dwt_cycles();
+    uint32_t deadline = start + 0x200;
+    wait_until(deadline);
+    uint32_t now = dwt_cycles();
+    TEST_ASSERT_TRUE(now - start >= 0x200);
+    TEST_ASSERT_TRUE(now - start < 0x210);
+    TEST_ASSERT_TRUE(now < 0x200);
+
+    // 已过的截止时刻只读一次计数器
+    dwt_mock_set(1000);
+    wait_until(500);
+    TEST_ASSERT_EQUAL_UINT32(1001, dwt_mock_cyccnt);
+}
+
+/*! @brief Cycles delay_ns waited, the mock counter advances one cycle per read */
+static uint32_t nsCycles(uint32_t ns)
+{
+    uint32_t before = dwt_mock_cyccnt;
+    delay_ns(ns);
+    // 减去读起点的一次
+    return dwt_mock_cyccnt - before - 1;
+}
+
+void test_dwt_delay_ns_rounds_up(void)
+{
+    dwt_delay_init();
+    TEST_ASSERT_EQUAL_UINT32(72, dwt_cycles_per_us);
+    TEST_ASSERT_EQUAL_UINT32(72, nsCycles(1000));
+    // 不足一个周期的部分向上取整
+    TEST_ASSERT_EQUAL_UINT32(1, nsCycles(1));
+    TEST_ASSERT_EQUAL_UINT32(2, nsCycles(14));
+    TEST_ASSERT_EQUAL_UINT32(73, nsCycles(1001));
+}
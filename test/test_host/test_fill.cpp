@@ -0,0 +1,104 @@
+/*!
+    @file test_fill.cpp
+    @brief Page-mask fill engine and the fast line hooks against the
+    drawPixel reference.
+*/
+
+#include "host_fixture.h"
+#include <stdlib.h>
+
+static uint8_t fast[128 * 8], reference[128 * 8];
+
+void test_fill_engine_matches_pixels(void)
+{
+    for (int rotation = LCD_Degrees_0; rotation <= LCD_Degrees_270; rotation++)
+    {
+        for (int scroll = 0; scroll < 2; scroll++)
+        {
+            memset(fast, 0, sizeof(fast));
+            memset(reference, 0, sizeof(reference));
+            ST7565_Bus_Recording r1, r2;
+            ST7565_Parallel lcd(128, 64, &r1);
+            ST7565_PixelReference ref(128, 64, &r2);
+            ST7565_Parallel_Screen s1(fast, 128, 64, 0, 0), s2(reference, 128, 64, 0, 0);
+            lcd.ActiveBuffer = &s1;
+            ref.ActiveBuffer = &s2;
+            lcd.LCDbegin();
+            ref.LCDbegin();
+            lcd.setRotation((LCD_rotate_e)rotation);
+            ref.setRotation((LCD_rotate_e)rotation);
+            if (scroll)
+            {
+                lcd.LCDscroll(13);
+                ref.LCDscroll(13);
+            }
+            srand(rotation * 2 + scroll);
+            for (int k = 0; k < 500; k++)
+            {
+                int x = rand() % 150 - 10, y = rand() % 150 - 10, w = rand() % 80 + 1, h = rand() % 80 + 1, c = rand() % 3;
+                lcd.fillRect(x, y, w, h, c);
+                ref.fillRect(x, y, w, h, c);
+                TEST_ASSERT_EQUAL_MEMORY(reference, fast, sizeof(fast));
+                if (k % 50 == 0)
+                {
+                    lcd.LCDupdate();
+                    ref.LCDupdate();
+                    TEST_ASSERT_EQUAL(0, glassDiff(r1, r2));
+                }
+            }
+        }
+    }
+}
+
+void test_fast_lines_match_pixels(void)
+{
+    for (int rotation = LCD_Degrees_0; rotation <= LCD_Degrees_270; rotation++)
+    {
+        memset(fast, 0, sizeof(fast));
+        memset(reference, 0, sizeof(reference));
+        ST7565_Bus_Recording r1, r2;
+        ST7565_Parallel lcd(128, 64, &r1);
+        ST7565_PixelReference ref(128, 64, &r2);
+        ST7565_Parallel_Screen s1(fast, 128, 64, 0, 0), s2(reference, 128, 64, 0, 0);
+        lcd.ActiveBuffer = &s1;
+        ref.ActiveBuffer = &s2;
+        lcd.setRotation((LCD_rotate_e)rotation);
+        ref.setRotation((LCD_rotate_e)rotation);
+        srand(rotation);
+        for (int k = 0; k < 400; k++)
+        {
+            int x = rand() % 140 - 6, y = rand() % 140 - 6, w = rand() % 60 + 8, h = rand() % 60 + 8;
+            int r = rand() % 4 + 1, c = rand() % 3;
+            switch (rand() % 6)
+            {
+            case 0:
+                lcd.drawRect(x, y, w, h, c);
+                ref.drawRect(x, y, w, h, c);
+                break;
+            case 1:
+                lcd.fillCircle(x, y, r * 3, c);
+                ref.fillCircle(x, y, r * 3, c);
+                break;
+            case 2:
+                lcd.fillRoundRect(x, y, w, h, r, c);
+                ref.fillRoundRect(x, y, w, h, r, c);
+                break;
+            case 3:
+                lcd.fillTriangle(x, y, x + w, y + 5, x + 3, y + h, c);
+                ref.fillTriangle(x, y, x + w, y + 5, x + 3, y + h, c);
+                break;
+            case 4:
+                lcd.drawRoundRect(x, y, w, h, r, c);
+                ref.drawRoundRect(x, y, w, h, r, c);
+                break;
+            default:
+                lcd.drawFastHLine(x, y, w, c);
+                ref.drawFastHLine(x, y, w, c);
+                lcd.drawFastVLine(x, y, h, c);
+                ref.drawFastVLine(x, y, h, c);
+                break;
+            }
+            TEST_ASSERT_EQUAL_MEMORY(reference, fast, sizeof(fast));
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*!
+    @file test_icons.cpp
+    @brief Table driven icon row: batched state changes and LCDupdateIcons.
+*/
+
+#include "host_fixture.h"
+
+static uint8_t buffer[128 * 8];
+
+void test_icon_states(void)
+{
+    for (int mode = LCD_Diff_Off; mode <= LCD_Diff_Hash; mode++)
+    {
+        memset(buffer, 0, sizeof(buffer));
+        ST7565_Bus_Recording rec;
+        ST7565_Parallel lcd(128, 64, &rec);
+        ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+        lcd.ActiveBuffer = &screen;
+        lcd.LCDDiffModeSet((LCD_DiffMode_e)mode);
+        lcd.LCDbegin();
+
+        lcd.drawPixel(5, 5, FOREGROUND);
+        uint8_t states[LCD_ICON_COUNT] = {1, 5, LCD_ICON_KEEP, 1, LCD_ICON_KEEP, 4, 0, 1};
+        TEST_ASSERT_EQUAL(LCD_Success, lcd.setIconStates(states, LCD_ICON_COUNT));
+        rec.clear();
+        lcd.LCDupdateIcons();
+        // 只发图标行，显示区的脏像素留给 LCDupdate
+        TEST_ASSERT_EQUAL_HEX8(0x00, rec.getRam(0, 5));
+        TEST_ASSERT_EQUAL_HEX8(0xFF, rec.getRam(8, 93));
+        TEST_ASSERT_EQUAL(LCD_IconRange, lcd.setIconState(2, 2));
+        rec.clear();
+        lcd.LCDupdate();
+        TEST_ASSERT_EQUAL_UINT32(1, rec.getDataBytes());
+
+        srand(mode);
+        for (int frame = 0; frame < 100; frame++)
+        {
+            for (int k = 0; k < 10; k++)
+            {
+                lcd.drawPixel(rand() % 128, rand() % 64, rand() % 3);
+            }
+            lcd.setIconState(rand() % LCD_ICON_COUNT, rand() % 2);
+            if (rand() % 2)
+            {
+                lcd.LCDupdateIcons();
+            }
+            else
+            {
+                lcd.LCDupdate();
+            }
+        }
+        lcd.LCDupdate();
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+    }
+}
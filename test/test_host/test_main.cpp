@@ -0,0 +1,81 @@
+/*!
+    @file test_main.cpp
+    @brief Host test runner: `pio test -e native` builds the driver sources
+    against the recording bus and the DWT mock.
+*/
+
+#include <unity.h>
+
+void test_double_buffer_needs_screen(void);
+void test_double_buffer_swap(void);
+void test_strip_matches_frame_buffer(void);
+void test_diff_shadow_sends_changed_bytes(void);
+void test_diff_hash_skips_unchanged_chunks(void);
+void test_diff_modes_random(void);
+void test_update_regions(void);
+void test_update_region_resends_glass(void);
+void test_fill_engine_matches_pixels(void);
+void test_fast_lines_match_pixels(void);
+void test_icon_states(void);
+void test_panel_sizes(void);
+void test_panel_crtp_primitives(void);
+void test_panel_crtp_other_screen(void);
+void test_scroll_follows_model(void);
+void test_scroll_costs_one_text_line(void);
+void test_scroll_region_update(void);
+void test_transpose_matches_rotation(void);
+void test_transpose_double_buffer(void);
+void test_transpose_panel(void);
+void test_dwt_mock_delay(void);
+void test_dwt_wait_until_wraps(void);
+void test_dwt_delay_ns_rounds_up(void);
+void test_begin_sends_full_frame(void);
+void test_update_sends_dirty_columns(void);
+void test_update_paths_agree(void);
+void test_offset_screen(void);
+void test_shadowed_commands(void);
+void test_invert_and_all_points(void);
+void test_begin_async_from_tick(void);
+void test_updates_wait_for_begin_async(void);
+void test_spi_backend(void);
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_double_buffer_needs_screen);
+    RUN_TEST(test_double_buffer_swap);
+    RUN_TEST(test_strip_matches_frame_buffer);
+    RUN_TEST(test_diff_shadow_sends_changed_bytes);
+    RUN_TEST(test_diff_hash_skips_unchanged_chunks);
+    RUN_TEST(test_diff_modes_random);
+    RUN_TEST(test_update_regions);
+    RUN_TEST(test_update_region_resends_glass);
+    RUN_TEST(test_fill_engine_matches_pixels);
+    RUN_TEST(test_fast_lines_match_pixels);
+    RUN_TEST(test_icon_states);
+    RUN_TEST(test_panel_sizes);
+    RUN_TEST(test_panel_crtp_primitives);
+    RUN_TEST(test_panel_crtp_other_screen);
+    RUN_TEST(test_scroll_follows_model);
+    RUN_TEST(test_scroll_costs_one_text_line);
+    RUN_TEST(test_scroll_region_update);
+    RUN_TEST(test_transpose_matches_rotation);
+    RUN_TEST(test_transpose_double_buffer);
+    RUN_TEST(test_transpose_panel);
+    RUN_TEST(test_dwt_mock_delay);
+    RUN_TEST(test_dwt_wait_until_wraps);
+    RUN_TEST(test_dwt_delay_ns_rounds_up);
+    RUN_TEST(test_begin_sends_full_frame);
+    RUN_TEST(test_update_sends_dirty_columns);
+    RUN_TEST(test_update_paths_agree);
+    RUN_TEST(test_offset_screen);
+    RUN_TEST(test_shadowed_commands);
+    RUN_TEST(test_invert_and_all_points);
+    RUN_TEST(test_begin_async_from_tick);
+    RUN_TEST(test_updates_wait_for_begin_async);
+    RUN_TEST(test_spi_backend);
+    return UNITY_END();
+}
@@ -0,0 +1,158 @@
+/*!
+    @file test_panel.cpp
+    @brief ST7565_Panel against ST7565_Parallel: the fixed size fast path
+    and the CRTP primitives must draw the same pixels.
+*/
+
+#include "host_fixture.h"
+#include "ST7565_Panel.h"
+
+template <class Panel, int W, int H>
+static void panelMatches(bool icons)
+{
+    static uint8_t reference[132 * 8];
+    for (int rotation = LCD_Degrees_0; rotation <= LCD_Degrees_270; rotation++)
+    {
+        memset(reference, 0, sizeof(reference));
+        ST7565_Bus_Recording r1, r2;
+        Panel panel(&r1);
+        ST7565_Parallel lcd(W, H, &r2);
+        ST7565_Parallel_Screen screen(reference, W, H, 0, 0);
+        lcd.ActiveBuffer = &screen;
+        panel.LCDbegin();
+        lcd.LCDbegin();
+        panel.setRotation((LCD_rotate_e)rotation);
+        lcd.setRotation((LCD_rotate_e)rotation);
+        srand(rotation);
+        for (int frame = 0; frame < 10; frame++)
+        {
+            for (int k = 0; k < 50; k++)
+            {
+                int x = rand() % 140 - 4, y = rand() % 70 - 3, c = rand() % 3;
+                panel.drawPixel(x, y, c);
+                lcd.drawPixel(x, y, c);
+            }
+            panel.fillRect(3, 3, 20, 9, COLORINVERSE);
+            lcd.fillRect(3, 3, 20, 9, COLORINVERSE);
+            panel.LCD_DrawIcon_Battery(frame % 5);
+            lcd.LCD_DrawIcon_Battery(frame % 5);
+            panel.LCDupdate();
+            lcd.LCDupdate();
+            TEST_ASSERT_EQUAL_MEMORY(reference, panel.ActiveBuffer->screenBuffer, W * H / 8);
+            for (int page = 0; page < H / 8; page++)
+            {
+                for (int column = 0; column < W; column++)
+                {
+                    TEST_ASSERT_EQUAL_HEX8(r2.getRam(page, column), r1.getRam(page, column));
+                }
+            }
+            TEST_ASSERT_EQUAL_HEX8(icons ? r2.getRam(8, 93) : 0, r1.getRam(8, 93));
+        }
+    }
+}
+
+void test_panel_sizes(void)
+{
+    panelMatches<ST7565_Panel_128x64, 128, 64>(true);
+    panelMatches<ST7565_Panel_128x32, 128, 32>(true);
+    panelMatches<ST7565_Panel_132x64, 132, 64>(true);
+    panelMatches<ST7565_Panel<128, 64, 0>, 128, 64>(false);
+}
+
+void test_panel_crtp_primitives(void)
+{
+    static uint8_t reference[128 * 8];
+    static ST7565_Bus_Recording r1, r2;
+    static ST7565_Panel_128x64 panel(&r2);
+    char text[] = "Hi 42!";
+    for (int rotation = LCD_Degrees_0; rotation <= LCD_Degrees_270; rotation++)
+    {
+        memset(reference, 0, sizeof(reference));
+        panel.LCDclearBuffer();
+        ST7565_Parallel lcd(128, 64, &r1);
+        ST7565_Parallel_Screen screen(reference, 128, 64, 0, 0);
+        lcd.ActiveBuffer = &screen;
+        lcd.setRotation((LCD_rotate_e)rotation);
+        panel.setRotation((LCD_rotate_e)rotation);
+        uint8_t *panelBuffer = panel.ActiveBuffer->screenBuffer;
+        srand(rotation);
+        for (int k = 0; k < 400; k++)
+        {
+            int x = rand() % 140 - 6, y = rand() % 140 - 6, w = rand() % 60 + 8, h = rand() % 60 + 8;
+            int r = rand() % 4 + 1, c = rand() % 3;
+            LCD_Return_Codes_e expected = LCD_Success, actual = LCD_Success;
+            switch (rand() % 8)
+            {
+            case 0:
+                lcd.drawRect(x, y, w, h, c);
+                panel.drawRect(x, y, w, h, c);
+                break;
+            case 1:
+                lcd.fillCircle(x, y, r * 3, c);
+                panel.fillCircle(x, y, r * 3, c);
+                lcd.drawCircle(y, x, r * 5, c);
+                panel.drawCircle(y, x, r * 5, c);
+                break;
+            case 2:
+                lcd.fillRoundRect(x, y, w, h, r, c);
+                panel.fillRoundRect(x, y, w, h, r, c);
+                break;
+            case 3:
+                lcd.fillTriangle(x, y, x + w, y + 5, x + 3, y + h, c);
+                panel.fillTriangle(x, y, x + w, y + 5, x + 3, y + h, c);
+                lcd.drawTriangle(x, y, x + w, y + 5, x + 3, y + h, c);
+                panel.drawTriangle(x, y, x + w, y + 5, x + 3, y + h, c);
+                break;
+            case 4:
+                lcd.drawRoundRect(x, y, w, h, r, c);
+                panel.drawRoundRect(x, y, w, h, r, c);
+                break;
+            case 5:
+                lcd.drawLine(x, y, w, h, c);
+                panel.drawLine(x, y, w, h, c);
+                break;
+            case 6:
+                lcd.setFontNum((LCD_Font_Type_e)(1 + r));
+                panel.setFontNum((LCD_Font_Type_e)(1 + r));
+                expected = lcd.drawText(x & 127, y & 63, text, c & 1, !(c & 1), (r & 1) ? 1 : 2);
+                actual = panel.drawText(x & 127, y & 63, text, c & 1, !(c & 1), (r & 1) ? 1 : 2);
+                break;
+            default:
+            {
+                // 经基类引用仍走虚函数路径
+                ST7565_graphics &base = panel;
+                lcd.drawLine(x, y, h, w, c);
+                base.drawLine(x, y, h, w, c);
+                break;
+            }
+            }
+            TEST_ASSERT_EQUAL(expected, actual);
+            TEST_ASSERT_EQUAL_MEMORY(reference, panelBuffer, sizeof(reference));
+        }
+    }
+}
+
+void test_panel_crtp_other_screen(void)
+{
+    static uint8_t reference[128 * 8], other[128 * 8], blank[128 * 8];
+    static ST7565_Bus_Recording r1, r2;
+    static ST7565_Panel_128x64 panel(&r2);
+    ST7565_Parallel lcd(128, 64, &r1);
+    ST7565_Parallel_Screen screen(reference, 128, 64, 0, 0), otherScreen(other, 128, 64, 0, 0);
+    ST7565_Parallel_Screen *own = panel.ActiveBuffer;
+    panel.LCDclearBuffer();
+    lcd.ActiveBuffer = &screen;
+    lcd.setRotation(LCD_Degrees_90);
+    panel.setRotation(LCD_Degrees_90);
+    // 另一块屏幕激活时图元走通用路径，不写面板缓冲
+    panel.ActiveBuffer = &otherScreen;
+    lcd.drawLine(3, 5, 60, 40, 1);
+    panel.drawLine(3, 5, 60, 40, 1);
+    lcd.fillCircle(30, 70, 12, 1);
+    panel.fillCircle(30, 70, 12, 1);
+    lcd.drawTriangle(2, 2, 50, 9, 20, 100, 2);
+    panel.drawTriangle(2, 2, 50, 9, 20, 100, 2);
+    TEST_ASSERT_EQUAL_MEMORY(reference, other, sizeof(reference));
+    TEST_ASSERT_EQUAL_MEMORY(blank, own->screenBuffer, sizeof(blank));
+    panel.ActiveBuffer = own;
+}
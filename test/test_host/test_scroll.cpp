@@ -0,0 +1,147 @@
+/*!
+    @file test_scroll.cpp
+    @brief Hardware scroll through the start line register: the glass seen
+    through the start line must follow a scrolled model of the picture.
+*/
+
+#include "host_fixture.h"
+#include "ST7565_Panel.h"
+
+static uint8_t buffer[128 * 8];
+static uint8_t model[64][128];
+
+/*! @brief Pixel shown at row y of the glass, taking the start line into account */
+static int visible(const ST7565_Bus_Recording &rec, int x, int y)
+{
+    int line = (y + rec.getStartLine()) & 63;
+    return (rec.getRam(line >> 3, x) >> (line & 7)) & 1;
+}
+
+template <class LCD>
+static void scrollMatchesModel(LCD &lcd, ST7565_Bus_Recording &rec, int seed, int rotation)
+{
+    memset(model, 0, sizeof(model));
+    lcd.setRotation((LCD_rotate_e)rotation);
+    int w = lcd.width(), h = lcd.height();
+    srand(seed);
+    for (int frame = 0; frame < 60; frame++)
+    {
+        int n = (rand() % 4 == 0) ? 8 : rand() % 20 - 6;
+        TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDscroll(n));
+        // 模型按物理行（0 度）滚动
+        static uint8_t scrolled[64][128];
+        memset(scrolled, 0, sizeof(scrolled));
+        for (int y = 0; y < 64; y++)
+        {
+            if (y + n >= 0 && y + n < 64)
+            {
+                memcpy(scrolled[y], model[y + n], 128);
+            }
+        }
+        memcpy(model, scrolled, sizeof(model));
+        for (int k = 0; k < 30; k++)
+        {
+            int x = rand() % w, y = rand() % h, c = rand() % 3;
+            lcd.drawPixel(x, y, c);
+            int px = x, py = y;
+            if (rotation == LCD_Degrees_90)
+            {
+                px = 127 - y;
+                py = x;
+            }
+            else if (rotation == LCD_Degrees_180)
+            {
+                px = 127 - x;
+                py = 63 - y;
+            }
+            else if (rotation == LCD_Degrees_270)
+            {
+                px = y;
+                py = 63 - x;
+            }
+            model[py][px] = (c == COLORINVERSE) ? (model[py][px] ^ 1) : c;
+        }
+        if (frame % 3 == 0)
+        {
+            LCD_Rect_t regions[2] = {{0, 0, (uint8_t)w, (uint8_t)h}, {0, 0, 1, 1}};
+            lcd.LCDupdateRegions(regions, 2);
+        }
+        else
+        {
+            lcd.LCDupdate();
+        }
+        for (int y = 0; y < 64; y++)
+        {
+            for (int x = 0; x < 128; x++)
+            {
+                TEST_ASSERT_EQUAL(model[y][x], visible(rec, x, y));
+            }
+        }
+    }
+}
+
+void test_scroll_follows_model(void)
+{
+    for (int mode = LCD_Diff_Off; mode <= LCD_Diff_Hash; mode++)
+    {
+        for (int rotation = LCD_Degrees_0; rotation <= LCD_Degrees_270; rotation++)
+        {
+            memset(buffer, 0, sizeof(buffer));
+            ST7565_Bus_Recording rec;
+            ST7565_Parallel lcd(128, 64, &rec);
+            ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+            lcd.ActiveBuffer = &screen;
+            lcd.LCDDiffModeSet((LCD_DiffMode_e)mode);
+            lcd.LCDbegin();
+            scrollMatchesModel(lcd, rec, mode * 7 + rotation, rotation);
+        }
+    }
+    static ST7565_Bus_Recording rec;
+    static ST7565_Panel_128x64 panel(&rec);
+    panel.LCDclearBuffer();
+    panel.LCDbegin();
+    scrollMatchesModel(panel, rec, 9, LCD_Degrees_0);
+}
+
+void test_scroll_costs_one_text_line(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+    char text[] = "new line";
+    rec.clear();
+    lcd.LCDscroll(8);
+    lcd.drawText(0, 56, text, FOREGROUND, BACKGROUND, 1);
+    lcd.LCDupdate();
+    TEST_ASSERT_TRUE(rec.getDataBytes() <= 128);
+
+    // 只支持整屏宽高的缓冲
+    ST7565_Parallel_Screen small(buffer, 64, 32, 0, 0);
+    lcd.ActiveBuffer = &small;
+    TEST_ASSERT_EQUAL(LCD_ScrollRange, lcd.LCDscroll(1));
+}
+
+void test_scroll_region_update(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+    lcd.LCDscroll(12);
+    lcd.LCDupdate();
+    lcd.drawPixel(10, 60, FOREGROUND);
+    lcd.drawPixel(20, 50, FOREGROUND);
+    lcd.drawPixel(30, 5, FOREGROUND);
+    lcd.LCDupdateRegion(0, 56, 128, 8);
+    TEST_ASSERT_EQUAL(1, visible(rec, 10, 60));
+    TEST_ASSERT_EQUAL(0, visible(rec, 20, 50));
+    TEST_ASSERT_EQUAL(0, visible(rec, 30, 5));
+    lcd.LCDupdateRegion(0, 0, 128, 8);
+    TEST_ASSERT_EQUAL(1, visible(rec, 30, 5));
+    TEST_ASSERT_EQUAL(0, visible(rec, 20, 50));
+}
@@ -0,0 +1,137 @@
+/*!
+    @file test_transpose.cpp
+    @brief Transposed 90/270 degree rotation: the portrait buffer converted
+    in 8x8 blocks must match drawing with setRotation directly.
+*/
+
+#include "host_fixture.h"
+#include "ST7565_Panel.h"
+#include <stdlib.h>
+
+static uint8_t direct[128 * 8], transposed[128 * 8], portrait[128 * 8];
+
+void test_transpose_matches_rotation(void)
+{
+    char text[] = "Ab3";
+    for (int rotation = LCD_Degrees_90; rotation <= LCD_Degrees_270; rotation += 2)
+    {
+        memset(direct, 0, sizeof(direct));
+        memset(transposed, 0, sizeof(transposed));
+        ST7565_Bus_Recording r1, r2;
+        ST7565_Parallel a(128, 64, &r1), b(128, 64, &r2);
+        ST7565_Parallel_Screen s1(direct, 128, 64, 0, 0), s2(transposed, 128, 64, 0, 0);
+        a.ActiveBuffer = &s1;
+        b.ActiveBuffer = &s2;
+        a.setRotation((LCD_rotate_e)rotation);
+        TEST_ASSERT_EQUAL(LCD_Success, b.LCDTransposeSet(portrait, (LCD_rotate_e)rotation));
+        TEST_ASSERT_EQUAL(64, b.width());
+        TEST_ASSERT_EQUAL(128, b.height());
+        a.LCDupdate();
+        b.LCDupdate();
+        TEST_ASSERT_EQUAL_UINT32(128, b.LCDTransposeBlocksGet());
+
+        srand(rotation);
+        for (int k = 0; k < 300; k++)
+        {
+            int x = rand() % 80 - 8, y = rand() % 140 - 6, w = rand() % 40 + 1, h = rand() % 60 + 1;
+            int r = rand() % 4 + 1, c = rand() % 3;
+            switch (rand() % 7)
+            {
+            case 0:
+                a.drawRect(x, y, w, h, c);
+                b.drawRect(x, y, w, h, c);
+                break;
+            case 1:
+                a.fillCircle(x, y, r * 3, c);
+                b.fillCircle(x, y, r * 3, c);
+                break;
+            case 2:
+                a.fillRect(x, y, w, h, c);
+                b.fillRect(x, y, w, h, c);
+                break;
+            case 3:
+                a.drawLine(x, y, w, h, c);
+                b.drawLine(x, y, w, h, c);
+                break;
+            case 4:
+                a.drawPixel(x, y, c);
+                b.drawPixel(x, y, c);
+                break;
+            case 5:
+                a.drawText(x & 63, y & 127, text, FOREGROUND, BACKGROUND, 1);
+                b.drawText(x & 63, y & 127, text, FOREGROUND, BACKGROUND, 1);
+                break;
+            default:
+                a.fillTriangle(x, y, x + w, y + 5, x + 3, y + h, c);
+                b.fillTriangle(x, y, x + w, y + 5, x + 3, y + h, c);
+                break;
+            }
+            if (k % 7 == 0)
+            {
+                a.LCDupdate();
+                b.LCDupdate();
+                TEST_ASSERT_EQUAL_MEMORY(direct, transposed, sizeof(direct));
+                TEST_ASSERT_EQUAL(0, glassDiff(r1, r2));
+            }
+        }
+        TEST_ASSERT_EQUAL(LCD_ScrollRange, b.LCDscroll(4));
+
+        // 只转换脏块
+        a.LCDclearBuffer();
+        b.LCDclearBuffer();
+        a.drawPixel(3, 100, FOREGROUND);
+        b.drawPixel(3, 100, FOREGROUND);
+        a.LCDupdate();
+        b.LCDupdate();
+        TEST_ASSERT_EQUAL_MEMORY(direct, transposed, sizeof(direct));
+        TEST_ASSERT_EQUAL_UINT32(1, b.LCDTransposeBlocksGet());
+
+        // 退出转置时先刷新未转换的像素
+        b.drawPixel(5, 5, FOREGROUND);
+        b.LCDTransposeSet(nullptr, LCD_Degrees_0);
+        a.drawPixel(5, 5, FOREGROUND);
+        TEST_ASSERT_EQUAL_MEMORY(direct, transposed, sizeof(direct));
+        a.drawPixel(6, 6, FOREGROUND);
+        b.drawPixel(6, 6, FOREGROUND);
+        TEST_ASSERT_EQUAL_MEMORY(direct, transposed, sizeof(direct));
+    }
+}
+
+void test_transpose_double_buffer(void)
+{
+    static uint8_t front[128 * 8];
+    memset(direct, 0, sizeof(direct));
+    memset(transposed, 0, sizeof(transposed));
+    ST7565_Bus_Recording r1, r2;
+    ST7565_Parallel a(128, 64, &r1), b(128, 64, &r2);
+    ST7565_Parallel_Screen s1(direct, 128, 64, 0, 0), s2(transposed, 128, 64, 0, 0);
+    a.ActiveBuffer = &s1;
+    b.ActiveBuffer = &s2;
+    TEST_ASSERT_EQUAL(LCD_Success, b.LCDDoubleBufferSet(front));
+    b.LCDTransposeSet(portrait, LCD_Degrees_90);
+    a.setRotation(LCD_Degrees_90);
+    a.fillCircle(30, 60, 20, FOREGROUND);
+    b.fillCircle(30, 60, 20, FOREGROUND);
+    b.LCDswap();
+    a.LCDupdate();
+    b.LCDupdate();
+    TEST_ASSERT_EQUAL(0, glassDiff(r1, r2));
+}
+
+void test_transpose_panel(void)
+{
+    static ST7565_Bus_Recording r1, r2;
+    static ST7565_Panel_128x64 panel(&r2);
+    memset(direct, 0, sizeof(direct));
+    ST7565_Parallel a(128, 64, &r1);
+    ST7565_Parallel_Screen s1(direct, 128, 64, 0, 0);
+    a.ActiveBuffer = &s1;
+    panel.LCDTransposeSet(portrait, LCD_Degrees_270);
+    a.setRotation(LCD_Degrees_270);
+    a.drawCircle(30, 60, 20, FOREGROUND);
+    panel.drawCircle(30, 60, 20, FOREGROUND);
+    a.fillRoundRect(3, 4, 40, 50, 5, COLORINVERSE);
+    panel.fillRoundRect(3, 4, 40, 50, 5, COLORINVERSE);
+    panel.LCDupdate();
+    TEST_ASSERT_EQUAL_MEMORY(direct, panel.LCDPanelScreenGet()->screenBuffer, sizeof(direct));
+}
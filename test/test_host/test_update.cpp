@@ -0,0 +1,268 @@
+/*!
+    @file test_update.cpp
+    @brief Bus backends, init sequence, dirty column updates and the
+    synchronous, DMA and interrupt update paths.
+*/
+
+#include "host_fixture.h"
+
+extern "C" volatile uint32_t uwTick;
+
+static uint8_t buffer[128 * 8];
+
+void test_begin_sends_full_frame(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+    // 8 页显示数据加图标行
+    TEST_ASSERT_EQUAL_UINT32(9 * 128, rec.getDataBytes());
+    TEST_ASSERT_EQUAL_UINT32(1, rec.getResets());
+    TEST_ASSERT_TRUE(rec.isDisplayOn());
+}
+
+void test_update_sends_dirty_columns(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+
+    lcd.fillRect(10, 10, 20, 20, FOREGROUND);
+    rec.clear();
+    lcd.LCDupdate();
+    // 第 1-3 页各 20 列
+    TEST_ASSERT_EQUAL_UINT32(60, rec.getDataBytes());
+    TEST_ASSERT_EQUAL_HEX8(0xFC, rec.getRam(1, 10));
+    TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+
+    rec.clear();
+    lcd.LCDupdate();
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getDataBytes());
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getCommandBytes());
+
+    lcd.LCDinvalidateAll();
+    rec.clear();
+    lcd.LCDupdate();
+    TEST_ASSERT_EQUAL_UINT32(9 * 128, rec.getDataBytes());
+}
+
+void test_update_paths_agree(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    ST7565_Bus_Recording rec;
+    rec.setAsync(true);
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+
+    srand(1);
+    for (int frame = 0; frame < 120; frame++)
+    {
+        for (int k = 0; k < 20; k++)
+        {
+            lcd.drawPixel(rand() % 128, rand() % 64, rand() % 3);
+        }
+        if (frame % 8 == 0)
+        {
+            lcd.LCD_DrawIcon_Battery(frame % 5);
+        }
+        switch (frame % 3)
+        {
+        case 0:
+            lcd.LCDupdate();
+            break;
+        case 1:
+            TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDupdateIT(1 + rand() % 9));
+            while (lcd.isBusy())
+            {
+                lcd.LCDrefreshTick();
+            }
+            break;
+        default:
+            TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDupdateAsync());
+            while (lcd.isBusy())
+            {
+                lcd.LCD_DMA_IRQHandler();
+            }
+            break;
+        }
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+    }
+}
+
+void test_offset_screen(void)
+{
+    static uint8_t small[100 * 4];
+    memset(buffer, 0, sizeof(buffer));
+    memset(small, 0, sizeof(small));
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+
+    // 左移 10 列、下移 2 页的小屏幕
+    ST7565_Parallel_Screen offset(small, 100, 32, -10, 16);
+    lcd.ActiveBuffer = &offset;
+    small[15] = 0xAA;
+    lcd.LCDupdate();
+    TEST_ASSERT_EQUAL_HEX8(0xAA, rec.getRam(2, 5));
+    lcd.drawPixel(50, 9, FOREGROUND);
+    lcd.LCDupdate();
+    TEST_ASSERT_EQUAL_HEX8(0x02, rec.getRam(3, 40));
+}
+
+void test_shadowed_commands(void)
+{
+    ST7565_Bus_Recording rec;
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+
+    rec.clear();
+    lcd.LCD_Contrast(0x20);
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getCommandBytes());
+    lcd.LCD_Contrast(0x21);
+    TEST_ASSERT_EQUAL(0x21, rec.getContrast());
+    rec.clear();
+    lcd.LCD_Contrast(0x21);
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getCommandBytes());
+}
+
+void test_invert_and_all_points(void)
+{
+    static LCD_BusRecord_t log[8];
+    ST7565_Bus_Recording rec(log, 8);
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+
+    // 反显和全亮各用自己的命令和影子，互不覆盖
+    rec.clear();
+    lcd.LCDInvertDisplay(1);
+    lcd.LCDallpixelsOn(1);
+    lcd.LCDInvertDisplay(1);
+    lcd.LCDallpixelsOn(1);
+    TEST_ASSERT_EQUAL_UINT32(2, rec.getLogLength());
+    TEST_ASSERT_EQUAL_HEX8(CMD_SET_DISP_REVERSE, log[0].value);
+    TEST_ASSERT_EQUAL_HEX8(CMD_SET_ALLPTS_ON, log[1].value);
+    rec.clear();
+    lcd.LCDallpixelsOn(0);
+    lcd.LCDInvertDisplay(0);
+    TEST_ASSERT_EQUAL_UINT32(2, rec.getLogLength());
+    TEST_ASSERT_EQUAL_HEX8(CMD_SET_ALLPTS_NORMAL, log[0].value);
+    TEST_ASSERT_EQUAL_HEX8(CMD_SET_DISP_NORMAL, log[1].value);
+}
+
+void test_begin_async_from_tick(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    buffer[5] = 0x5A;
+    for (int viaUpdate = 0; viaUpdate < 2; viaUpdate++)
+    {
+        ST7565_Bus_Recording rec;
+        ST7565_Parallel lcd(128, 64, &rec);
+        ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+        lcd.ActiveBuffer = &screen;
+        lcd.LCDbeginAsync();
+        // 节拍只发命令，整帧留给主循环
+        for (int ticks = 0; ticks < 1000; ticks++)
+        {
+            uwTick++;
+            lcd.LCDinitTick();
+        }
+        TEST_ASSERT_TRUE(rec.isDisplayOn());
+        TEST_ASSERT_EQUAL(1, rec.getResets());
+        TEST_ASSERT_EQUAL_UINT32(0, rec.getDataBytes());
+        if (viaUpdate)
+        {
+            lcd.LCDupdate();
+        }
+        TEST_ASSERT_TRUE(lcd.LCDinitDone());
+        TEST_ASSERT_EQUAL_HEX8(0x5A, rec.getRam(0, 5));
+        TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+        rec.clear();
+        lcd.LCDupdate();
+        TEST_ASSERT_EQUAL_UINT32(0, rec.getDataBytes());
+    }
+}
+
+void test_updates_wait_for_begin_async(void)
+{
+    static uint8_t strip[128];
+    static LCD_ListItem_t list[4];
+    memset(buffer, 0, sizeof(buffer));
+    buffer[7] = 0x3C;
+    ST7565_Bus_Recording rec;
+    rec.setAsync(true);
+    ST7565_Parallel lcd(128, 64, &rec);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbeginAsync();
+    uwTick++;
+    lcd.LCDinitTick();
+
+    // 命令序列未发完，刷新函数不碰总线
+    uint32_t commands = rec.getCommandBytes();
+    TEST_ASSERT_EQUAL(LCD_BusBusy, lcd.LCDupdateAsync());
+    TEST_ASSERT_EQUAL(LCD_BusBusy, lcd.LCDupdateIT(16));
+    lcd.LCDupdate();
+    lcd.LCDupdateRegion(0, 0, 128, 64);
+    lcd.LCDupdateIcons();
+    TEST_ASSERT_FALSE(lcd.isBusy());
+    TEST_ASSERT_EQUAL_UINT32(0, rec.getDataBytes());
+    TEST_ASSERT_EQUAL_UINT32(commands, rec.getCommandBytes());
+
+    // 命令发完后，第一个区域刷新先送出整帧
+    for (int ticks = 0; ticks < 1000; ticks++)
+    {
+        uwTick++;
+        lcd.LCDinitTick();
+    }
+    lcd.LCDupdateRegion(0, 0, 8, 8);
+    TEST_ASSERT_TRUE(lcd.LCDinitDone());
+    TEST_ASSERT_EQUAL_HEX8(0x3C, rec.getRam(0, 7));
+    TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+
+    ST7565_Bus_Recording striped;
+    ST7565_Parallel b(128, 64, &striped);
+    b.LCDStripBegin(list, 4, strip);
+    b.LCDbeginAsync();
+    TEST_ASSERT_EQUAL(LCD_BusBusy, b.LCDupdateStrip());
+    TEST_ASSERT_EQUAL_UINT32(0, striped.getDataBytes());
+}
+
+void test_spi_backend(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    ST7565_Bus_Recording rec;
+    ST7565_SpiPort_Recording port(&rec);
+    ST7565_Bus_Spi bus(&port, 20000000);
+    ST7565_Parallel lcd(128, 64, &bus);
+    ST7565_Parallel_Screen screen(buffer, 128, 64, 0, 0);
+    lcd.ActiveBuffer = &screen;
+    lcd.LCDbegin();
+    // 72 MHz 分频后不超过 20 MHz
+    TEST_ASSERT_EQUAL_UINT32(18000000, bus.getClockHz());
+
+    lcd.fillRect(10, 10, 20, 20, FOREGROUND);
+    rec.clear();
+    TEST_ASSERT_EQUAL(LCD_Success, lcd.LCDupdateAsync());
+    while (lcd.isBusy())
+    {
+        lcd.LCD_DMA_IRQHandler();
+    }
+    TEST_ASSERT_EQUAL_UINT32(60, rec.getDataBytes());
+    TEST_ASSERT_EQUAL_UINT32(0, port.getErrors());
+    TEST_ASSERT_FALSE(port.isSelected());
+    TEST_ASSERT_EQUAL(0, glassDiff(rec, buffer));
+}